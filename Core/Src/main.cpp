@@ -23,6 +23,9 @@
 /* USER CODE BEGIN Includes */
 #include "xuart_stream.h"
 #include "rtc_internal.h"
+#include "rtc_alarms.h"
+#include "rtc_timestamps.h"
+#include "boot_profile.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -45,6 +48,8 @@
 RTC_HandleTypeDef hrtc;
 
 UART_HandleTypeDef huart1;
+DMA_HandleTypeDef hdma_usart1_rx;
+DMA_HandleTypeDef hdma_usart1_tx;
 
 /* USER CODE BEGIN PV */
 
@@ -52,10 +57,14 @@ UART_HandleTypeDef huart1;
 
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
+static void MPU_Config(void);
 static void MX_GPIO_Init(void);
+static void MX_DMA_Init(void);
 static void MX_RTC_Init(void);
 static void MX_USART1_UART_Init(void);
 /* USER CODE BEGIN PFP */
+static void RTC_Resume(void);
+static void Deferred_Init(void);
 
 /* USER CODE END PFP */
 
@@ -71,15 +80,27 @@ static void MX_USART1_UART_Init(void);
 int main(void)
 {
   /* USER CODE BEGIN 1 */
+  auto& boot = boot_profile::get_instance();
+  boot.begin();
 
   /* USER CODE END 1 */
 
+  /* MPU Configuration--------------------------------------------------------*/
+  MPU_Config();
+
+  /* Enable I-Cache---------------------------------------------------------*/
+  SCB_EnableICache();
+
+  /* Enable D-Cache---------------------------------------------------------*/
+  SCB_EnableDCache();
+
   /* MCU Configuration--------------------------------------------------------*/
 
   /* Reset of all peripherals, Initializes the Flash interface and the Systick. */
   HAL_Init();
 
   /* USER CODE BEGIN Init */
+  boot.mark("MPU, caches, HAL_Init");
 
   /* USER CODE END Init */
 
@@ -87,24 +108,35 @@ int main(void)
   SystemClock_Config();
 
   /* USER CODE BEGIN SysInit */
+  boot.mark("SystemClock_Config");
 
   /* USER CODE END SysInit */
 
   /* Initialize all configured peripherals */
   MX_GPIO_Init();
+  MX_DMA_Init();
   MX_RTC_Init();
   MX_USART1_UART_Init();
   /* USER CODE BEGIN 2 */
+  boot.mark("MX_Init");
   xuart_stream::get_instance().init(huart1);
   auto& rtc = rtc_internal::get_instance();
   rtc.init(huart1);
+  boot.mark("rtc_internal");
+
+  if (!boot.is_warm())
+  {
+    Deferred_Init();
+  }
   /* USER CODE END 2 */
 
   /* Infinite loop */
   /* USER CODE BEGIN WHILE */
   while (true)
   {
-    rtc_internal::execute_cmd(rtc.parse_received_msg());
+    rtc.process_received_msgs();
+    rtc_alarms::get_instance().process();
+    Deferred_Init();
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
@@ -179,6 +211,11 @@ static void MX_RTC_Init(void)
 {
 
   /* USER CODE BEGIN RTC_Init 0 */
+  if (boot_profile::get_instance().is_warm())
+  {
+    RTC_Resume();
+    return;
+  }
 
   /* USER CODE END RTC_Init 0 */
 
@@ -270,6 +307,25 @@ static void MX_USART1_UART_Init(void)
 
 }
 
+/**
+  * Enable DMA controller clock
+  */
+static void MX_DMA_Init(void)
+{
+
+  /* DMA controller clock enable */
+  __HAL_RCC_DMA2_CLK_ENABLE();
+
+  /* DMA interrupt init */
+  /* DMA2_Stream2_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA2_Stream2_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(DMA2_Stream2_IRQn);
+  /* DMA2_Stream7_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA2_Stream7_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(DMA2_Stream7_IRQn);
+
+}
+
 /**
   * @brief GPIO Initialization Function
   * @param None
@@ -303,9 +359,94 @@ static void MX_GPIO_Init(void)
 }
 
 /* USER CODE BEGIN 4 */
+/**
+  * @brief  Takes over the running RTC on the warm boot instead of MX_RTC_Init().
+  * @note   HAL_RTC_Init() would stop the calendar in the initialization mode
+  *         and restart the current second. The calendar, the prescalers and
+  *         the calibration are kept as they are.
+  */
+static void RTC_Resume(void)
+{
+  hrtc.Instance = RTC;
+  hrtc.Init.HourFormat = RTC->CR & RTC_CR_FMT;
+  hrtc.Init.AsynchPrediv = (RTC->PRER & RTC_PRER_PREDIV_A) >> RTC_PRER_PREDIV_A_Pos;
+  hrtc.Init.SynchPrediv = RTC->PRER & RTC_PRER_PREDIV_S;
+  hrtc.Init.OutPut = RTC_OUTPUT_DISABLE;
+  hrtc.Init.OutPutPolarity = RTC_OUTPUT_POLARITY_HIGH;
+  hrtc.Init.OutPutType = RTC_OUTPUT_TYPE_OPENDRAIN;
+  hrtc.Lock = HAL_UNLOCKED;
+  HAL_RTC_MspInit(&hrtc);
+  hrtc.State = HAL_RTC_STATE_READY;
+}
+
+/**
+  * @brief  The init which is not needed to answer the commands. On the warm
+  *         boot it is run by the main loop after the first pass. The boot
+  *         profile is sent to UART by the BOOT command only.
+  */
+static void Deferred_Init(void)
+{
+  static bool done = false;
+  if (done)
+  {
+    return;
+  }
+
+  done = true;
+  auto& boot = boot_profile::get_instance();
+
+  if (boot.is_warm())
+  {
+    boot.mark("First main loop pass");
+  }
+
+  rtc_internal::get_instance().start_epoch_clock();
+
+  if (rtc_timestamps::get_instance().start() != HAL_OK)
+  {
+    Error_Handler();
+  }
+
+  boot.mark("Deferred init");
+}
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef* huart)
+{
+  rtc_internal::get_instance().uart_error_callback(huart);
+  xuart_stream::get_instance().uart_error_callback(huart);
+}
 
 /* USER CODE END 4 */
 
+ /* MPU Configuration */
+
+void MPU_Config(void)
+{
+  MPU_Region_InitTypeDef MPU_InitStruct = {0};
+
+  /* Disables the MPU */
+  HAL_MPU_Disable();
+
+  /** Initializes and configures the Region and the memory to be protected
+  */
+  MPU_InitStruct.Enable = MPU_REGION_ENABLE;
+  MPU_InitStruct.Number = MPU_REGION_NUMBER0;
+  MPU_InitStruct.BaseAddress = 0x2004C000;
+  MPU_InitStruct.Size = MPU_REGION_SIZE_16KB;
+  MPU_InitStruct.SubRegionDisable = 0x0;
+  MPU_InitStruct.TypeExtField = MPU_TEX_LEVEL1;
+  MPU_InitStruct.AccessPermission = MPU_REGION_FULL_ACCESS;
+  MPU_InitStruct.DisableExec = MPU_INSTRUCTION_ACCESS_DISABLE;
+  MPU_InitStruct.IsShareable = MPU_ACCESS_SHAREABLE;
+  MPU_InitStruct.IsCacheable = MPU_ACCESS_NOT_CACHEABLE;
+  MPU_InitStruct.IsBufferable = MPU_ACCESS_NOT_BUFFERABLE;
+
+  HAL_MPU_ConfigRegion(&MPU_InitStruct);
+  /* Enables the MPU */
+  HAL_MPU_Enable(MPU_PRIVILEGED_DEFAULT);
+
+}
+
 /**
   * @brief  This function is executed in case of error occurrence.
   * @retval None
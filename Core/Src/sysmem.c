@@ -24,6 +24,26 @@
 #include <errno.h>
 #include <stdint.h>
 
+#if NO_HEAP
+/* Tells the linker script to reserve no heap and to reject malloc */
+__asm (".global _no_heap\n.set _no_heap, 1");
+
+/**
+ * @brief _sbrk() of the NO_HEAP build: nothing may allocate. The linker script
+ *        rejects malloc() linked in, this catches the allocations it can't see.
+ *        BKPT halts the debugger, without one it escalates to HardFault.
+ *
+ * @param incr Memory size
+ * @return Never returns a memory
+ */
+void *_sbrk(ptrdiff_t incr)
+{
+  (void)incr;
+  __asm volatile ("bkpt #0");
+  errno = ENOMEM;
+  return (void *)-1;
+}
+#else
 /**
  * Pointer to the current high watermark of the heap usage
  */
@@ -77,3 +97,4 @@ void *_sbrk(ptrdiff_t incr)
 
   return (void *)prev_heap_end;
 }
+#endif /* NO_HEAP */
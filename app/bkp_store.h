@@ -0,0 +1,184 @@
+/**
+  ******************************************************************************
+  * @file           : bkp_store.h
+  * @author         : Rusanov M.N.
+  * @version        : V1.0.0
+  * @date           : 16-Oct-2026
+  * @brief          : Typed key/value store over the RTC backup registers.
+  *                   Each key is a type derived from bkp_field<T>, the
+  *                   registers of the fields are allocated at compile time
+  *                   in the order of the template arguments of bkp_store.
+  *                   The first register holds the layout id (version and
+  *                   size of the layout), the second one the CRC-32 of the
+  *                   layout id and all fields.
+  * @note           : The store is not thread-safe. A reset during set()
+  *                   leaves a wrong CRC, so the whole store is invalid on
+  *                   the next boot rather than partly updated.
+  *
+  ******************************************************************************
+  */
+
+#pragma once
+
+#include <cstring>
+#include <type_traits>
+#include "main.h"
+
+template<typename T>
+struct bkp_field
+{
+  static_assert(std::is_trivially_copyable_v<T>, "The field must be trivially copyable");
+
+  using type = T;
+  static constexpr size_t words = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+};
+
+namespace bkp_crc
+{
+  struct nibble_table
+  {
+    uint32_t values[16];
+  };
+
+  constexpr nibble_table make_nibble_table()
+  {
+    nibble_table result = {};
+
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+      uint32_t crc = i;
+      for (int bit = 0; bit < 4; ++bit)
+      {
+        crc = (crc >> 1) ^ ((crc & 1U) ? 0xEDB88320U : 0U);
+      }
+
+      result.values[i] = crc;
+    }
+
+    return result;
+  }
+
+  inline constexpr nibble_table table = make_nibble_table();
+
+  /**
+    * @brief  Adds the word to the CRC-32 (IEEE 802.3), least significant byte first.
+    */
+  constexpr uint32_t add(uint32_t crc, const uint32_t word)
+  {
+    crc ^= word;
+    for (int nibble = 0; nibble < 8; ++nibble)
+    {
+      crc = (crc >> 4) ^ table.values[crc & 0x0FU];
+    }
+
+    return crc;
+  }
+
+  // CRC-32 of "1234" is 0x9BE3E0A3
+  static_assert((add(0xFFFFFFFFU, 0x34333231U) ^ 0xFFFFFFFFU) == 0x9BE3E0A3U);
+}
+
+template<uint8_t Version, typename... Fields>
+class bkp_store
+{
+public:
+  static constexpr size_t header_words = 2; // Layout id, CRC
+  static constexpr size_t data_words = (Fields::words + ... + 0);
+  static constexpr uint32_t layout_id = (0xB5U << 24) | (static_cast<uint32_t>(Version) << 16) | data_words;
+  static_assert(header_words + data_words <= RTC_BKP_NUMBER, "The fields don't fit in the backup registers");
+
+  /**
+    * @retval true if the registers hold this layout and the CRC matches.
+    */
+  [[nodiscard]] static bool is_valid()
+  {
+    return (reg(0) == layout_id) && (reg(1) == crc());
+  }
+
+  /**
+    * @brief  Zeroes all fields and writes the layout id.
+    */
+  static void reset()
+  {
+    for (size_t i = header_words; i < header_words + data_words; ++i)
+    {
+      reg(i) = 0;
+    }
+
+    reg(0) = layout_id;
+    reg(1) = crc();
+  }
+
+  template<typename Field>
+  [[nodiscard]] static typename Field::type get()
+  {
+    uint32_t words[Field::words];
+    for (size_t i = 0; i < Field::words; ++i)
+    {
+      words[i] = reg(offset<Field>() + i);
+    }
+
+    typename Field::type value;
+    std::memcpy(&value, words, sizeof(value));
+    return value;
+  }
+
+  template<typename Field>
+  static void set(const typename Field::type& value)
+  {
+    uint32_t words[Field::words] = {};
+    std::memcpy(words, &value, sizeof(value));
+
+    for (size_t i = 0; i < Field::words; ++i)
+    {
+      reg(offset<Field>() + i) = words[i];
+    }
+
+    reg(1) = crc();
+  }
+
+  /**
+    * @brief  Adds the value to the numeric field.
+    */
+  template<typename Field>
+  static void add(const typename Field::type value)
+  {
+    static_assert(std::is_arithmetic_v<typename Field::type>, "The field must be numeric");
+
+    if (value != 0)
+    {
+      set<Field>(get<Field>() + value);
+    }
+  }
+
+private:
+  /**
+    * @retval Index of the first register of the field.
+    */
+  template<typename Field>
+  static constexpr size_t offset()
+  {
+    static_assert((std::is_same_v<Field, Fields> || ...), "The field doesn't belong to the store");
+
+    size_t result = header_words;
+    bool found = false;
+    ((found = found || std::is_same_v<Field, Fields>, result += found ? 0 : Fields::words), ...);
+    return result;
+  }
+
+  static volatile uint32_t& reg(const size_t index)
+  {
+    return (&RTC->BKP0R)[index];
+  }
+
+  static uint32_t crc()
+  {
+    uint32_t result = bkp_crc::add(0xFFFFFFFFU, reg(0));
+    for (size_t i = header_words; i < header_words + data_words; ++i)
+    {
+      result = bkp_crc::add(result, reg(i));
+    }
+
+    return result ^ 0xFFFFFFFFU;
+  }
+};
@@ -0,0 +1,98 @@
+/**
+  ******************************************************************************
+  * @file           : boot_profile.cpp
+  * @author         : Rusanov M.N.
+  ******************************************************************************
+  */
+
+#include "boot_profile.h"
+#include "xprintf.h"
+
+boot_profile::boot_profile() = default;
+
+boot_profile& boot_profile::get_instance()
+{
+  static boot_profile instance;
+  return instance;
+}
+
+/**
+  * @brief  Starts the cycle counter and detects the warm boot: a reset other
+  *         than power-on/brown-out with the LSE and the RTC calendar running.
+  */
+void boot_profile::begin()
+{
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->LAR = 0xC5ACCE55; // Unlock the DWT registers of the Cortex-M7
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  f_start = 0;
+  f_clock_hz = SystemCoreClock;
+  f_size = 0;
+
+  f_reset_flags = RCC->CSR & (RCC_CSR_BORRSTF | RCC_CSR_PINRSTF | RCC_CSR_PORRSTF | RCC_CSR_SFTRSTF |
+                              RCC_CSR_IWDGRSTF | RCC_CSR_WWDGRSTF | RCC_CSR_LPWRRSTF);
+  __HAL_RCC_CLEAR_RESET_FLAGS();
+
+  const uint32_t bdcr = RCC->BDCR;
+  f_warm = ((f_reset_flags & (RCC_CSR_BORRSTF | RCC_CSR_PORRSTF)) == 0U) &&
+           ((bdcr & RCC_BDCR_LSERDY) != 0U) &&
+           ((bdcr & RCC_BDCR_RTCEN) != 0U) &&
+           ((RTC->ISR & RTC_ISR_INITS) != 0U);
+}
+
+/**
+  * @brief  Ends the current stage and begins the next one.
+  * @param  stage : name of the stage being ended, must be a string literal.
+  */
+void boot_profile::mark(const char* stage)
+{
+  const uint32_t now = DWT->CYCCNT;
+
+  if (f_size < max_stages)
+  {
+    f_stages[f_size++] = { stage, now - f_start, f_clock_hz };
+  }
+
+  f_start = DWT->CYCCNT;
+  f_clock_hz = SystemCoreClock;
+}
+
+/**
+  * @brief  Sends the duration of each stage to UART in format
+  *         "Boot stage: n us (n cycles)\r".
+  * @note   A stage which switches the core clock is converted to us with
+  *         the clock it has started with.
+  */
+void boot_profile::report() const
+{
+  xprintf("Boot %s, reset flags 0x%02lX\r", f_warm ? "warm" : "cold",
+    static_cast<unsigned long>(f_reset_flags >> RCC_CSR_BORRSTF_Pos));
+
+  uint32_t total_us = 0;
+
+  for (size_t i = 0; i < f_size; ++i)
+  {
+    const uint32_t us = f_stages[i].cycles / (f_stages[i].clock_hz / 1000000U);
+    total_us += us;
+    xprintf("Boot %s: %lu us (%lu cycles)\r", f_stages[i].name,
+      static_cast<unsigned long>(us),
+      static_cast<unsigned long>(f_stages[i].cycles));
+  }
+
+  xprintf("Boot total: %lu us\r", static_cast<unsigned long>(total_us));
+}
+
+bool boot_profile::is_warm() const
+{
+  return f_warm;
+}
+
+/**
+  * @retval RCC_CSR reset flags of the last reset.
+  */
+uint32_t boot_profile::reset_flags() const
+{
+  return f_reset_flags;
+}
@@ -0,0 +1,51 @@
+/**
+  ******************************************************************************
+  * @file           : boot_profile.h
+  * @author         : Rusanov M.N.
+  * @version        : V1.0.0
+  * @date           : 16-Oct-2026
+  * @brief          : Header for boot_profile.cpp file.
+  *                   Measures the init stages with the DWT cycle counter and
+  *                   tells the warm boot (reset with the LSE and the RTC
+  *                   already running) from the cold one.
+  * @note           : The profile is sent to UART by the BOOT command.
+  *                   begin() must be the first call of main(): it reads the
+  *                   reset flags before anything else and clears them.
+  *
+  ******************************************************************************
+  */
+
+#pragma once
+
+#include "main.h"
+
+class boot_profile
+{
+public:
+  static constexpr size_t max_stages = 8;
+
+  [[nodiscard]] static boot_profile& get_instance();
+  void begin();
+  void mark(const char* stage);
+  void report() const;
+  [[nodiscard]] bool is_warm() const;
+  [[nodiscard]] uint32_t reset_flags() const;
+
+private:
+  struct stage
+  {
+    const char* name;
+    uint32_t cycles;
+    uint32_t clock_hz; // Core clock at the beginning of the stage
+  };
+
+  explicit boot_profile();
+
+private:
+  stage f_stages[max_stages] = {};
+  size_t f_size = 0;
+  uint32_t f_start = 0;    // DWT_CYCCNT at the beginning of the current stage
+  uint32_t f_clock_hz = 0; // Core clock at the beginning of the current stage
+  uint32_t f_reset_flags = 0;
+  bool f_warm = false;
+};
@@ -0,0 +1,309 @@
+/**
+  ******************************************************************************
+  * @file           : cmd_table.h
+  * @author         : Rusanov M.N.
+  * @version        : V1.0.0
+  * @date           : 16-Oct-2026
+  * @brief          : Compile-time perfect hash table of command keywords.
+  *                   The keywords are hashed by snw1::basic_static_string::hash(),
+  *                   the received ones by @ref hash(): the table is not valid
+  *                   if the two differ for any keyword.
+  *                   The table size is chosen at compile time so that every
+  *                   keyword gets its own slot. The lookup costs one hash of
+  *                   the keyword and one compare regardless of the number
+  *                   of commands.
+  *                   The table also keeps the keywords sorted, so the
+  *                   keywords starting with a prefix are a range of them.
+  *                   A byte-at-a-time parser narrows the range by
+  *                   @ref extend() and rejects an unknown command on the first
+  *                   char which no keyword has after the received prefix.
+  *
+  ******************************************************************************
+  */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include "static_string.h"
+
+template<typename Value, size_t Count>
+class cmd_table
+{
+  static_assert(Count > 0 && Count < UINT8_MAX, "Wrong number of commands");
+
+public:
+  static constexpr size_t max_length = 16; // Max length of a keyword
+
+  struct entry
+  {
+    const char* keyword;
+    size_t length;
+    Value value;
+    unsigned long long hash; // By snw1::basic_static_string::hash()
+  };
+
+  // Range of the sorted keywords starting with the received prefix
+  struct prefix
+  {
+    uint8_t first;
+    uint8_t last; // Past the end
+  };
+
+  static constexpr prefix all_keywords = { 0, Count };
+
+  /**
+    * @brief  Incremental form of @ref hash(): the keyword is fed char by char
+    *         from its beginning, the result is the same.
+    */
+  class hasher
+  {
+  public:
+    void add(const char c)
+    {
+      f_sum += static_cast<unsigned long long>(c + 1) * f_pow;
+      f_pow *= 33ULL;
+    }
+
+    [[nodiscard]] unsigned long long value() const
+    {
+      return 5381ULL * f_pow + f_sum;
+    }
+
+  private:
+    unsigned long long f_sum = 0;
+    unsigned long long f_pow = 1;
+  };
+
+  template<size_t Size>
+  [[nodiscard]] static constexpr entry make_entry(const snw1::basic_static_string<char, Size>& keyword,
+                                                  const Value value)
+  {
+    return { keyword.data, keyword.length(), value, keyword.hash() };
+  }
+
+  constexpr explicit cmd_table(const entry (&entries)[Count])
+  {
+    for (size_t i = 0; i < Count; ++i)
+    {
+      f_entries[i] = entries[i];
+      f_hashes[i] = fold(entries[i].hash);
+
+      if ((entries[i].length > max_length) || (hash(entries[i].keyword, entries[i].length) != entries[i].hash))
+      {
+        return; // Not valid: too long, or the runtime hash differs from the static one
+      }
+
+      for (size_t pos = 0; pos < entries[i].length; ++pos)
+      {
+        const auto c = static_cast<unsigned char>(entries[i].keyword[pos]);
+        if ((c == 0) || (c >= 128))
+        {
+          return; // Not valid
+        }
+      }
+
+      // Insertion sort of the keywords
+      size_t j = i;
+      for (; (j > 0) && is_less(i, f_sorted[j - 1]); --j)
+      {
+        f_sorted[j] = f_sorted[j - 1];
+      }
+
+      f_sorted[j] = static_cast<uint8_t>(i);
+    }
+
+    for (uint32_t modulus = Count; modulus <= max_slots; ++modulus)
+    {
+      if (try_modulus(modulus))
+      {
+        f_modulus = modulus;
+        break;
+      }
+    }
+  }
+
+  /**
+    * @brief  Same as snw1::basic_static_string::hash() but for the keyword
+    *         which is not known at compile time.
+    */
+  [[nodiscard]] static constexpr unsigned long long hash(const char* str, const size_t length)
+  {
+    unsigned long long result = 5381ULL;
+    for (size_t i = length; i > 0; --i)
+    {
+      result = result * 33ULL + static_cast<unsigned long long>(str[i - 1] + 1);
+    }
+
+    return result;
+  }
+
+  /**
+    * @retval true if the keywords are ASCII, not longer than @ref max_length,
+    *         @ref hash() gives the same as snw1::basic_static_string::hash()
+    *         for every keyword and the perfect hash has been found.
+    */
+  [[nodiscard]] constexpr bool is_valid() const
+  {
+    return f_modulus != 0;
+  }
+
+  /**
+    * @brief  Narrows the range of the keywords starting with the prefix of
+    *         length pos to those followed by the char c, in O(log Count).
+    * @param  range : @ref all_keywords for the empty prefix.
+    * @retval false if no keyword starts with the prefix and c.
+    */
+  [[nodiscard]] bool extend(prefix& range, const size_t pos, const char c) const
+  {
+    const auto uc = static_cast<unsigned char>(c);
+    if (uc == 0)
+    {
+      return false;
+    }
+
+    const uint8_t first = bound(range, pos, uc, false);
+    const uint8_t last = bound({ first, range.last }, pos, uc, true);
+    range = { first, last };
+    return first != last;
+  }
+
+  [[nodiscard]] constexpr uint32_t slots() const
+  {
+    return f_modulus;
+  }
+
+  /**
+    * @retval Keyword of the value or nullptr if it has none.
+    */
+  [[nodiscard]] constexpr const char* keyword(const Value value) const
+  {
+    for (const entry& item : f_entries)
+    {
+      if (item.value == value)
+      {
+        return item.keyword;
+      }
+    }
+
+    return nullptr;
+  }
+
+  /**
+    * @retval Pointer to the value of the keyword or nullptr if it is unknown.
+    */
+  [[nodiscard]] const Value* find(const char* keyword, const size_t length) const
+  {
+    return find(keyword, length, hash(keyword, length));
+  }
+
+  /**
+    * @param  keyword_hash : hash of the keyword computed by @ref hasher.
+    */
+  [[nodiscard]] const Value* find(const char* keyword, const size_t length,
+                                  const unsigned long long keyword_hash) const
+  {
+    const uint8_t index = f_slots[fold(keyword_hash) % f_modulus];
+    if (index >= Count)
+    {
+      return nullptr;
+    }
+
+    const entry& item = f_entries[index];
+    if ((item.length != length) || (std::memcmp(item.keyword, keyword, length) != 0))
+    {
+      return nullptr;
+    }
+
+    return &item.value;
+  }
+
+private:
+  static constexpr uint32_t max_slots = 4 * Count + 8;
+
+  [[nodiscard]] static constexpr uint32_t fold(const unsigned long long hash)
+  {
+    return static_cast<uint32_t>(hash ^ (hash >> 32));
+  }
+
+  /**
+    * @retval Char of the keyword at the position, 0 past its end.
+    */
+  [[nodiscard]] constexpr unsigned char char_at(const size_t index, const size_t pos) const
+  {
+    const entry& item = f_entries[index];
+    return (pos < item.length) ? static_cast<unsigned char>(item.keyword[pos]) : 0;
+  }
+
+  /**
+    * @retval true if the keyword lhs sorts before rhs, a prefix before
+    *         the longer keywords.
+    */
+  [[nodiscard]] constexpr bool is_less(const size_t lhs, const size_t rhs) const
+  {
+    for (size_t pos = 0; pos <= max_length; ++pos)
+    {
+      if (char_at(lhs, pos) != char_at(rhs, pos))
+      {
+        return char_at(lhs, pos) < char_at(rhs, pos);
+      }
+    }
+
+    return false;
+  }
+
+  /**
+    * @retval The first keyword of the range whose char at the position is
+    *         not less (upper is false) or greater (upper is true) than c.
+    *         The chars at the position are sorted within the range.
+    */
+  [[nodiscard]] uint8_t bound(const prefix range, const size_t pos, const unsigned char c, const bool upper) const
+  {
+    uint8_t first = range.first;
+    uint8_t last = range.last;
+
+    while (first != last)
+    {
+      const auto middle = static_cast<uint8_t>(first + (last - first) / 2);
+      const unsigned char middle_c = char_at(f_sorted[middle], pos);
+
+      if (upper ? (middle_c <= c) : (middle_c < c))
+      {
+        first = static_cast<uint8_t>(middle + 1);
+      }
+      else
+      {
+        last = middle;
+      }
+    }
+
+    return first;
+  }
+
+  constexpr bool try_modulus(const uint32_t modulus)
+  {
+    for (uint32_t i = 0; i < max_slots; ++i)
+    {
+      f_slots[i] = Count;
+    }
+
+    for (size_t i = 0; i < Count; ++i)
+    {
+      uint8_t& slot = f_slots[f_hashes[i] % modulus];
+      if (slot != Count)
+      {
+        return false;
+      }
+
+      slot = static_cast<uint8_t>(i);
+    }
+
+    return true;
+  }
+
+  entry f_entries[Count] = {};
+  uint32_t f_hashes[Count] = {};
+  uint8_t f_slots[max_slots] = {};
+  uint8_t f_sorted[Count] = {}; // Indexes of the entries in the order of the keywords
+  uint32_t f_modulus = 0;
+};
@@ -0,0 +1,74 @@
+/**
+  ******************************************************************************
+  * @file           : cpu_cache.h
+  * @author         : Rusanov M.N.
+  * @version        : V1.0.0
+  * @date           : 16-Oct-2026
+  * @brief          : Cortex-M7 D-cache maintenance of the buffers shared with
+  *                   DMA. Buffers placed by DMA_BUFFER in the .dma_buffer
+  *                   section (SRAM2, non-cacheable by MPU_Config()) need none.
+  *                   Cacheable buffers must be cleaned before DMA reads them
+  *                   and invalidated before the CPU reads what DMA has written.
+  * @note           : The DTCM (0x20000000...0x2000FFFF) is never cached,
+  *                   the maintenance of its addresses does nothing.
+  *
+  ******************************************************************************
+  */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include "main.h"
+
+// Places the variable into the non-cacheable SRAM2 region, it is not zeroed at startup
+#define DMA_BUFFER __attribute__((section(".dma_buffer")))
+
+namespace cpu_cache
+{
+  inline constexpr size_t line_size = 32; // Bytes, fixed on Cortex-M7
+
+  namespace detail
+  {
+    inline uint32_t* line_begin(const volatile void* addr)
+    {
+      return reinterpret_cast<uint32_t*>(reinterpret_cast<uintptr_t>(addr) & ~(line_size - 1));
+    }
+
+    inline int32_t lines_size(const volatile void* addr, const size_t size)
+    {
+      const uintptr_t begin = reinterpret_cast<uintptr_t>(addr);
+      const uintptr_t end = (begin + size + line_size - 1) & ~(line_size - 1);
+      return static_cast<int32_t>(end - (begin & ~(line_size - 1)));
+    }
+  }
+
+  /**
+    * @brief  Writes the cached data of the buffer to the memory before DMA reads it.
+    *         The cache lines around the buffer are written too, which is harmless.
+    */
+  inline void clean(const volatile void* addr, const size_t size)
+  {
+    SCB_CleanDCache_by_Addr(detail::line_begin(addr), detail::lines_size(addr, size));
+  }
+
+  /**
+    * @brief  Discards the cached data of the buffer before the CPU reads what DMA
+    *         has written.
+    * @note   The buffer must be aligned to and sized in @ref line_size, otherwise
+    *         the data of the neighbours sharing its cache lines is lost.
+    */
+  inline void invalidate(volatile void* addr, const size_t size)
+  {
+    SCB_InvalidateDCache_by_Addr(detail::line_begin(addr), detail::lines_size(addr, size));
+  }
+
+  /**
+    * @brief  @ref clean() and @ref invalidate() at once, for the buffers both
+    *         written by the CPU and received by DMA.
+    */
+  inline void clean_invalidate(volatile void* addr, const size_t size)
+  {
+    SCB_CleanInvalidateDCache_by_Addr(detail::line_begin(addr), detail::lines_size(addr, size));
+  }
+}
@@ -0,0 +1,101 @@
+/**
+  ******************************************************************************
+  * @file           : cycle_profile.cpp
+  * @author         : Rusanov M.N.
+  ******************************************************************************
+  */
+
+#include "cycle_profile.h"
+#include <algorithm>
+#include "xprintf.h"
+
+cycle_profile::cycle_profile() = default;
+
+cycle_profile& cycle_profile::get_instance()
+{
+  static cycle_profile instance;
+  return instance;
+}
+
+/**
+  * @brief  Adds the duration to the histogram of the slot.
+  * @param  name : name of the slot, must be a string literal.
+  */
+void cycle_profile::add(const size_t slot, const char* name, const uint32_t cycles)
+{
+#if RELEASE
+  static_cast<void>(slot);
+  static_cast<void>(name);
+  static_cast<void>(cycles);
+#else
+  if (slot >= max_slots)
+  {
+    return;
+  }
+
+  histogram& item = f_slots[slot];
+  item.name = name;
+  item.min = (item.count == 0) ? cycles : std::min(item.min, cycles);
+  item.max = std::max(item.max, cycles);
+  item.sum += cycles;
+  ++item.count;
+  ++item.counts[31 - __CLZ(cycles | 1U)];
+#endif
+}
+
+/**
+  * @brief  Sends the histograms to UART in format
+  *         "name: n calls, min n, avg n, max n, p99 n cycles\r".
+  * @note   p99 is the upper bound of the log2 bucket, so it overestimates
+  *         up to twice.
+  */
+void cycle_profile::report() const
+{
+#if RELEASE
+  xprintf("Error: No stats in the Release build!\r");
+#else
+  size_t count = 0;
+
+  for (const histogram& item : f_slots)
+  {
+    if (item.count == 0)
+    {
+      continue;
+    }
+
+    ++count;
+    xprintf("%s: %lu calls, min %lu, avg %lu, max %lu, p99 %lu cycles\r", item.name,
+      static_cast<unsigned long>(item.count),
+      static_cast<unsigned long>(item.min),
+      static_cast<unsigned long>(item.sum / item.count),
+      static_cast<unsigned long>(item.max),
+      static_cast<unsigned long>(percentile(item, 99)));
+  }
+
+  if (count == 0)
+  {
+    xprintf("Stats: no probes hit\r");
+  }
+#endif
+}
+
+/**
+  * @retval Upper bound of the bucket holding the percentile, at most the max.
+  */
+uint32_t cycle_profile::percentile(const histogram& item, const uint32_t percent)
+{
+  const uint64_t rank = (static_cast<uint64_t>(item.count) * percent + 99) / 100;
+  uint64_t total = 0;
+
+  for (size_t bucket = 0; bucket < buckets; ++bucket)
+  {
+    total += item.counts[bucket];
+    if (total >= rank)
+    {
+      const uint32_t upper = (bucket == buckets - 1) ? UINT32_MAX : ((2U << bucket) - 1U);
+      return std::min(upper, item.max);
+    }
+  }
+
+  return item.max;
+}
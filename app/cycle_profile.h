@@ -0,0 +1,86 @@
+/**
+  ******************************************************************************
+  * @file           : cycle_profile.h
+  * @author         : Rusanov M.N.
+  * @version        : V1.0.0
+  * @date           : 16-Oct-2026
+  * @brief          : Header for cycle_profile.cpp file.
+  *                   Latency histograms measured with the DWT cycle counter.
+  *                   CYCLE_PROBE(slot, name) measures the rest of its scope
+  *                   and adds the cycles to the histogram of the slot.
+  *                   Each histogram keeps min/max/sum and log2 buckets:
+  *                   bucket b counts the durations of 2^b...2^(b+1)-1 cycles.
+  * @note           : The probes and the histograms are compiled out in
+  *                   the Release configuration (RELEASE defined).
+  *                   The cycle counter is started by boot_profile::begin().
+  *                   A slot must be fed either from the main loop or from
+  *                   one interrupt, the report may read a histogram being
+  *                   updated by an interrupt.
+  *
+  ******************************************************************************
+  */
+
+#pragma once
+
+#include "main.h"
+
+#if RELEASE
+#define CYCLE_PROBE(slot, name) static_cast<void>(0)
+#else
+#define CYCLE_PROBE_NAME(line) cycle_probe_##line
+#define CYCLE_PROBE_AT(slot, name, line) const cycle_probe CYCLE_PROBE_NAME(line)((slot), (name))
+#define CYCLE_PROBE(slot, name) CYCLE_PROBE_AT(slot, name, __LINE__)
+#endif
+
+class cycle_profile
+{
+public:
+  static constexpr size_t max_slots = 20;
+  static constexpr size_t buckets = 32; // log2 of the cycles
+
+  [[nodiscard]] static cycle_profile& get_instance();
+  void add(size_t slot, const char* name, uint32_t cycles);
+  void report() const;
+
+private:
+  struct histogram
+  {
+    const char* name;
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t counts[buckets]; // Durations per log2 bucket
+  };
+
+  explicit cycle_profile();
+  [[nodiscard]] static uint32_t percentile(const histogram& item, uint32_t percent);
+
+private:
+#if !RELEASE
+  histogram f_slots[max_slots] = {};
+#endif
+};
+
+#if !RELEASE
+class cycle_probe
+{
+public:
+  cycle_probe(const size_t slot, const char* name) : f_slot(slot), f_name(name), f_start(DWT->CYCCNT)
+  {
+  }
+
+  ~cycle_probe()
+  {
+    cycle_profile::get_instance().add(f_slot, f_name, DWT->CYCCNT - f_start);
+  }
+
+  cycle_probe(const cycle_probe&) = delete;
+  cycle_probe& operator=(const cycle_probe&) = delete;
+
+private:
+  const size_t f_slot;
+  const char* const f_name;
+  const uint32_t f_start;
+};
+#endif
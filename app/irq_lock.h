@@ -0,0 +1,36 @@
+/**
+  ******************************************************************************
+  * @file           : irq_lock.h
+  * @author         : Rusanov M.N.
+  * @version        : V1.0.0
+  * @date           : 16-Oct-2026
+  * @brief          : Scoped critical section: masks the interrupts in the
+  *                   constructor and restores the previous PRIMASK state in
+  *                   the destructor, so the locks may be nested.
+  *
+  ******************************************************************************
+  */
+
+#pragma once
+
+#include "main.h"
+
+class irq_lock
+{
+public:
+  irq_lock() : f_primask(__get_PRIMASK())
+  {
+    __disable_irq();
+  }
+
+  ~irq_lock()
+  {
+    __set_PRIMASK(f_primask);
+  }
+
+  irq_lock(const irq_lock&) = delete;
+  irq_lock& operator=(const irq_lock&) = delete;
+
+private:
+  const uint32_t f_primask;
+};
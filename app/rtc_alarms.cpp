@@ -0,0 +1,193 @@
+/**
+  ******************************************************************************
+  * @file           : rtc_alarms.cpp
+  * @author         : Rusanov M.N.
+  ******************************************************************************
+  */
+
+#include "rtc_alarms.h"
+#include <algorithm>
+#include "xprintf.h"
+#include "rtc_calendar.h"
+#include "rtc_internal.h"
+
+extern RTC_HandleTypeDef hrtc;
+
+rtc_alarms::rtc_alarms() = default;
+
+rtc_alarms& rtc_alarms::get_instance()
+{
+  static rtc_alarms instance;
+  return instance;
+}
+
+/**
+  * @brief  Adds the alarm in O(log n).
+  * @param  epoch_s : deadline, seconds since 01/01/1970. A deadline in the past
+  *         fires on the next @ref process().
+  * @param  callback : called by @ref process() on the deadline,
+  *         "ALARM id" is sent to UART if it is nullptr.
+  * @retval Id of the alarm or @ref no_alarm if the pool is full.
+  */
+uint16_t rtc_alarms::add(const int64_t epoch_s, const alarm_callback callback, void* context)
+{
+  if (f_size >= max_alarms)
+  {
+    return no_alarm;
+  }
+
+  const uint16_t id = f_next_id;
+  f_next_id = (f_next_id == UINT16_MAX) ? 1 : (f_next_id + 1);
+
+  f_heap[f_size++] = { epoch_s, callback, context, id };
+  std::push_heap(f_heap, f_heap + f_size, later);
+
+  if (f_heap[0].id == id)
+  {
+    program_next();
+  }
+
+  return id;
+}
+
+/**
+  * @retval false if there is no such alarm.
+  */
+bool rtc_alarms::cancel(const uint16_t id)
+{
+  alarm* const end = f_heap + f_size;
+  alarm* const item = std::find_if(f_heap, end, [id](const alarm& a) { return a.id == id; });
+
+  if (item == end)
+  {
+    return false;
+  }
+
+  const bool was_next = (item == f_heap);
+  *item = f_heap[--f_size];
+  std::make_heap(f_heap, f_heap + f_size, later);
+
+  if (was_next)
+  {
+    program_next();
+  }
+
+  return true;
+}
+
+size_t rtc_alarms::size() const
+{
+  return f_size;
+}
+
+/**
+  * @brief  This function must be called in the main loop.
+  *         Fires all due alarms and programs the next deadline.
+  */
+void rtc_alarms::process()
+{
+  if (!f_pending)
+  {
+    return;
+  }
+
+  f_pending = false;
+
+  const int64_t now = now_s();
+
+  while ((f_size > 0) && (f_heap[0].epoch_s <= now))
+  {
+    std::pop_heap(f_heap, f_heap + f_size, later);
+    fire(f_heap[--f_size]);
+  }
+
+  program_next();
+}
+
+/**
+  * @brief  Must be called after the calendar has been written.
+  * @note   Alarm A matches the day of month and the time, so a deadline
+  *         skipped by the write would match again only a month later.
+  *         The alarms due at the new time are fired by the next @ref process(),
+  *         which programs Alarm A from the new time.
+  */
+void rtc_alarms::calendar_changed()
+{
+  f_pending = true;
+}
+
+void HAL_RTC_AlarmAEventCallback(RTC_HandleTypeDef* hrtc)
+{
+  rtc_alarms::get_instance().rtc_alarm_a_callback(hrtc);
+}
+
+void rtc_alarms::rtc_alarm_a_callback(const RTC_HandleTypeDef* rtc_handle)
+{
+  if (rtc_handle == &hrtc)
+  {
+    f_pending = true;
+  }
+}
+
+/**
+  * @brief  Heap order: the nearest deadline is on the top.
+  */
+bool rtc_alarms::later(const alarm& lhs, const alarm& rhs)
+{
+  return lhs.epoch_s > rhs.epoch_s;
+}
+
+int64_t rtc_alarms::now_s()
+{
+  return rtc_internal::get_instance().epoch_ms() / 1000;
+}
+
+/**
+  * @brief  Programs Alarm A with the nearest deadline.
+  * @note   Alarm A matches the day of month and the time, so a deadline more
+  *         than a month ahead may match earlier. Such a match is not due yet
+  *         and the same deadline is just programmed again.
+  */
+void rtc_alarms::program_next()
+{
+  if (f_size == 0)
+  {
+    static_cast<void>(HAL_RTC_DeactivateAlarm(&hrtc, RTC_ALARM_A));
+    return;
+  }
+
+  RTC_DateTypeDef date = {};
+  RTC_TimeTypeDef time = {};
+  rtc_calendar::from_epoch_ms(f_heap[0].epoch_s * 1000, date, time);
+
+  RTC_AlarmTypeDef alarm_set = {};
+  alarm_set.Alarm = RTC_ALARM_A;
+  alarm_set.AlarmTime = time;
+  alarm_set.AlarmMask = RTC_ALARMMASK_NONE;
+  alarm_set.AlarmSubSecondMask = RTC_ALARMSUBSECONDMASK_ALL;
+  alarm_set.AlarmDateWeekDaySel = RTC_ALARMDATEWEEKDAYSEL_DATE;
+  alarm_set.AlarmDateWeekDay = date.Date;
+
+  if (const auto res = HAL_RTC_SetAlarm_IT(&hrtc, &alarm_set, RTC_FORMAT_BIN);
+      res != HAL_OK)
+  {
+    xprintf("Error %u: Failed to set alarm!\r", res);
+  }
+
+  if (f_heap[0].epoch_s <= now_s())
+  {
+    f_pending = true; // The deadline has passed before Alarm A was set
+  }
+}
+
+void rtc_alarms::fire(const alarm& item)
+{
+  if (item.callback != nullptr)
+  {
+    item.callback(item.id, item.context);
+  }
+  else
+  {
+    xprintf("ALARM %u\r", item.id);
+  }
+}
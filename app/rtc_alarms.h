@@ -0,0 +1,57 @@
+/**
+  ******************************************************************************
+  * @file           : rtc_alarms.h
+  * @author         : Rusanov M.N.
+  * @version        : V1.0.0
+  * @date           : 16-Oct-2026
+  * @brief          : Header for rtc_alarms.cpp file.
+  *                   Software alarms multiplexed onto RTC Alarm A. The alarms
+  *                   are kept in a fixed-size min-heap ordered by deadline,
+  *                   only the nearest deadline is programmed into the RTC.
+  * @note           : The alarms are fired by the main loop, not by the
+  *                   interrupt, so the callbacks may print and use the HAL.
+  *
+  ******************************************************************************
+  */
+
+#pragma once
+
+#include "main.h"
+
+class rtc_alarms
+{
+public:
+  using alarm_callback = void (*)(uint16_t id, void* context);
+
+  static constexpr size_t max_alarms = 16;
+  static constexpr uint16_t no_alarm = 0;
+
+  [[nodiscard]] static rtc_alarms& get_instance();
+  [[nodiscard]] uint16_t add(int64_t epoch_s, alarm_callback callback = nullptr, void* context = nullptr);
+  [[nodiscard]] bool cancel(uint16_t id);
+  [[nodiscard]] size_t size() const;
+  void process();
+  void calendar_changed();
+  void rtc_alarm_a_callback(const RTC_HandleTypeDef* rtc_handle);
+
+private:
+  struct alarm
+  {
+    int64_t epoch_s; // Deadline, seconds since 01/01/1970
+    alarm_callback callback;
+    void* context;
+    uint16_t id;
+  };
+
+  explicit rtc_alarms();
+  [[nodiscard]] static bool later(const alarm& lhs, const alarm& rhs);
+  [[nodiscard]] static int64_t now_s();
+  void program_next();
+  static void fire(const alarm& item);
+
+private:
+  alarm f_heap[max_alarms] = {};
+  size_t f_size = 0;
+  uint16_t f_next_id = 1;
+  volatile bool f_pending = false; // Set by Alarm A, the due alarms must be fired
+};
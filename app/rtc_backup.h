@@ -0,0 +1,41 @@
+/**
+  ******************************************************************************
+  * @file           : rtc_backup.h
+  * @author         : Rusanov M.N.
+  * @version        : V1.0.0
+  * @date           : 16-Oct-2026
+  * @brief          : Layout of the RTC backup registers: the state which
+  *                   survives the reset as long as the backup domain is powered.
+  * @note           : Increment the version whenever the meaning of a field
+  *                   changes, a change of the size is detected anyway.
+  *
+  ******************************************************************************
+  */
+
+#pragma once
+
+#include "bkp_store.h"
+#include "rtc_drift.h"
+
+namespace rtc_backup
+{
+  // Drift model, see @ref rtc_drift
+  struct drift_calibration : bkp_field<int32_t> {};
+  struct drift_size : bkp_field<uint32_t> {};
+  struct drift_samples : bkp_field<rtc_drift::samples> {};
+
+  // Error counters since the backup domain reset
+  struct rx_time_outs : bkp_field<uint32_t> {};
+  struct rx_queue_overflows : bkp_field<uint32_t> {};
+  struct dropped_samples : bkp_field<uint32_t> {};
+  struct lost_timestamps : bkp_field<uint32_t> {};
+
+  using store = bkp_store<1,
+                          drift_calibration,
+                          drift_size,
+                          drift_samples,
+                          rx_time_outs,
+                          rx_queue_overflows,
+                          dropped_samples,
+                          lost_timestamps>;
+}
@@ -0,0 +1,342 @@
+/**
+  ******************************************************************************
+  * @file           : rtc_calendar.h
+  * @author         : Rusanov M.N.
+  * @version        : V1.0.0
+  * @date           : 16-Oct-2026
+  * @brief          : Conversions between the RTC calendar and the Unix epoch.
+  *                   The day number is computed by the days_from_civil() and
+  *                   civil_from_days() algorithms of H. Hinnant: no loops and
+  *                   no month tables, everything is constexpr.
+  *                   The date validation and the day of year are looked up in
+  *                   the tables generated at compile time for the RTC years.
+  * @note           : The RTC keeps 2 digits of the year, the century is 2000.
+  *
+  ******************************************************************************
+  */
+
+#pragma once
+
+#include <cstdint>
+#include "main.h"
+
+namespace rtc_calendar
+{
+  constexpr int32_t rtc_base_year = 2000;
+  constexpr uint32_t rtc_years = 100; // RTC_DR stores 00...99
+  constexpr int64_t seconds_per_day = 86400;
+
+  struct civil_date
+  {
+    int32_t year;
+    uint32_t month; // 1...12
+    uint32_t day;   // 1...31
+  };
+
+  /**
+    * @retval Number of days since 01/01/1970, negative for the earlier dates.
+    */
+  constexpr int32_t days_from_civil(int32_t year, const uint32_t month, const uint32_t day)
+  {
+    year -= (month <= 2) ? 1 : 0;
+    const int32_t era = ((year >= 0) ? year : (year - 399)) / 400;
+    const auto year_of_era = static_cast<uint32_t>(year - era * 400);
+    const uint32_t day_of_year = (153 * ((month > 2) ? (month - 3) : (month + 9)) + 2) / 5 + day - 1;
+    const uint32_t day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + static_cast<int32_t>(day_of_era) - 719468;
+  }
+
+  /**
+    * @brief  Inverse of @ref days_from_civil().
+    */
+  constexpr civil_date civil_from_days(int32_t days)
+  {
+    days += 719468;
+    const int32_t era = ((days >= 0) ? days : (days - 146096)) / 146097;
+    const auto day_of_era = static_cast<uint32_t>(days - era * 146097);
+    const uint32_t year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    const uint32_t day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    const uint32_t mp = (5 * day_of_year + 2) / 153;
+    const uint32_t month = (mp < 10) ? (mp + 3) : (mp - 9);
+    const int32_t year = static_cast<int32_t>(year_of_era) + era * 400 + ((month <= 2) ? 1 : 0);
+    return { year, month, day_of_year - (153 * mp + 2) / 5 + 1 };
+  }
+
+  constexpr bool is_leap_year(const int32_t year)
+  {
+    return ((year % 4) == 0) && (((year % 100) != 0) || ((year % 400) == 0));
+  }
+
+  struct calendar_tables
+  {
+    uint8_t days_in_month[2][13];       // [leap][month], month 0 is not valid
+    uint16_t days_before_month[2][13];  // [leap][month], days of the year before the month
+    uint8_t leap[rtc_years];            // [year of the RTC]
+  };
+
+  constexpr calendar_tables make_calendar_tables()
+  {
+    calendar_tables result = {};
+
+    for (uint32_t leap = 0; leap < 2; ++leap)
+    {
+      for (uint32_t month = 1; month <= 12; ++month)
+      {
+        const uint8_t days = (month == 2) ? static_cast<uint8_t>(28 + leap) :
+                             (((month == 4) || (month == 6) || (month == 9) || (month == 11)) ? 30 : 31);
+        result.days_in_month[leap][month] = days;
+
+        if (month < 12)
+        {
+          result.days_before_month[leap][month + 1] =
+            static_cast<uint16_t>(result.days_before_month[leap][month] + days);
+        }
+      }
+    }
+
+    for (uint32_t year = 0; year < rtc_years; ++year)
+    {
+      result.leap[year] = is_leap_year(rtc_base_year + static_cast<int32_t>(year)) ? 1 : 0;
+    }
+
+    return result;
+  }
+
+  inline constexpr calendar_tables tables = make_calendar_tables();
+
+  /**
+    * @param  year : year of the RTC, 0...99.
+    * @param  month : 1...12.
+    */
+  constexpr uint8_t days_in_month(const uint8_t year, const uint8_t month)
+  {
+    return tables.days_in_month[tables.leap[year]][month];
+  }
+
+  constexpr bool is_valid_date(const RTC_DateTypeDef& date)
+  {
+    return (date.Year < rtc_years) && (date.Month >= 1) && (date.Month <= 12) &&
+           (date.Date >= 1) && (date.Date <= days_in_month(date.Year, date.Month));
+  }
+
+  /**
+    * @retval The value if it is within [min, max], otherwise min or max
+    *         if the value exceeds max and set_max is true.
+    */
+  constexpr uint8_t fix_field(const uint8_t value, const uint8_t min, const uint8_t max, const bool set_max)
+  {
+    if (value < min)
+    {
+      return min;
+    }
+
+    if (value > max)
+    {
+      return set_max ? max : min;
+    }
+
+    return value;
+  }
+
+  /**
+    * @brief  Brings the date into the RTC range: the year modulo 100, then
+    *         the month and the day clamped by @ref fix_field().
+    * @retval true if the date was valid and is left as it is.
+    */
+  constexpr bool fix_date(RTC_DateTypeDef& date, const bool set_max)
+  {
+    if (is_valid_date(date))
+    {
+      return true;
+    }
+
+    date.Year = static_cast<uint8_t>(date.Year % rtc_years);
+    date.Month = fix_field(date.Month, 1, 12, set_max);
+    date.Date = fix_field(date.Date, 1, days_in_month(date.Year, date.Month), set_max);
+
+    return false;
+  }
+
+  /**
+    * @retval Ordinal date: 1 for 1 January ... 365 or 366 for 31 December.
+    * @note   Not used by any command yet, checked by the host test only.
+    */
+  constexpr uint16_t day_of_year(const RTC_DateTypeDef& date)
+  {
+    return static_cast<uint16_t>(tables.days_before_month[tables.leap[date.Year]][date.Month] + date.Date);
+  }
+
+  /**
+    * @retval ISO week day: 1 (RTC_WEEKDAY_MONDAY) ... 7 (RTC_WEEKDAY_SUNDAY).
+    */
+  constexpr uint8_t weekday_from_days(const int32_t days)
+  {
+    return static_cast<uint8_t>((days >= -3) ? ((days + 3) % 7 + 1) : ((days + 4) % 7 + 7));
+  }
+
+  /**
+    * @brief  Week day by the method of T. Sakamoto.
+    * @retval ISO week day: 1 (RTC_WEEKDAY_MONDAY) ... 7 (RTC_WEEKDAY_SUNDAY).
+    */
+  constexpr uint8_t weekday(int32_t year, const uint32_t month, const uint32_t day)
+  {
+    constexpr uint8_t month_offsets[12] = { 0, 3, 2, 5, 0, 3, 5, 1, 4, 6, 2, 4 };
+
+    year -= (month < 3) ? 1 : 0;
+    const auto sunday_based = static_cast<uint32_t>(year + year / 4 - year / 100 + year / 400 +
+                                                    month_offsets[month - 1] + static_cast<int32_t>(day)) % 7;
+    return static_cast<uint8_t>((sunday_based == 0) ? 7 : sunday_based);
+  }
+
+  constexpr uint8_t weekday(const RTC_DateTypeDef& date)
+  {
+    return weekday(rtc_base_year + date.Year, date.Month, date.Date);
+  }
+
+  // Names of RTC_WEEKDAY_xxx, the week day is 0 if it has never been set
+  inline constexpr const char* weekday_names[8] = { "???", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun" };
+
+  constexpr int32_t days_from_rtc(const RTC_DateTypeDef& date)
+  {
+    return days_from_civil(rtc_base_year + date.Year, date.Month, date.Date);
+  }
+
+  /**
+    * @note   The 12-hour format is not taken into account.
+    */
+  constexpr uint32_t seconds_of_day(const RTC_TimeTypeDef& time)
+  {
+    return time.Hours * 3600U + time.Minutes * 60U + time.Seconds;
+  }
+
+  /**
+    * @retval Milliseconds elapsed since the beginning of the second:
+    *         the sub-seconds count down from the second fraction (PREDIV_S).
+    *         Negative right after a shift operation, when SSR > PREDIV_S:
+    *         the time is then TR - 1 s + (PREDIV_S - SSR) / (PREDIV_S + 1),
+    *         so adding the result to the seconds of TR borrows the second.
+    */
+  constexpr int32_t milliseconds(const uint32_t sub_seconds, const uint32_t second_fraction)
+  {
+    const int32_t scaled = (static_cast<int32_t>(second_fraction) - static_cast<int32_t>(sub_seconds)) * 1000;
+    const auto ticks_per_s = static_cast<int32_t>(second_fraction + 1U);
+    return ((scaled >= 0) ? scaled : (scaled - ticks_per_s + 1)) / ticks_per_s; // Rounded down
+  }
+
+  constexpr int32_t milliseconds(const RTC_TimeTypeDef& time)
+  {
+    return milliseconds(time.SubSeconds, time.SecondFraction);
+  }
+
+  constexpr int64_t to_epoch_s(const RTC_DateTypeDef& date, const RTC_TimeTypeDef& time)
+  {
+    return days_from_rtc(date) * seconds_per_day + seconds_of_day(time);
+  }
+
+  constexpr int64_t to_epoch_ms(const RTC_DateTypeDef& date, const RTC_TimeTypeDef& time)
+  {
+    return to_epoch_s(date, time) * 1000 + milliseconds(time);
+  }
+
+  /**
+    * @brief  Fills the calendar fields by the time since the epoch.
+    *         SubSeconds are set for SecondFraction given in time.
+    * @note   The dates out of 2000...2099 can't be stored by the RTC.
+    */
+  constexpr void from_epoch_ms(const int64_t epoch_ms, RTC_DateTypeDef& date, RTC_TimeTypeDef& time)
+  {
+    const int64_t epoch_s = ((epoch_ms >= 0) ? epoch_ms : (epoch_ms - 999)) / 1000;
+    const auto ms = static_cast<uint32_t>(epoch_ms - epoch_s * 1000);
+    const int64_t days = ((epoch_s >= 0) ? epoch_s : (epoch_s - seconds_per_day + 1)) / seconds_per_day;
+    const auto second_of_day = static_cast<uint32_t>(epoch_s - days * seconds_per_day);
+    const civil_date civil = civil_from_days(static_cast<int32_t>(days));
+
+    date.Year = static_cast<uint8_t>(civil.year - rtc_base_year);
+    date.Month = static_cast<uint8_t>(civil.month);
+    date.Date = static_cast<uint8_t>(civil.day);
+    date.WeekDay = weekday_from_days(static_cast<int32_t>(days));
+
+    time.Hours = static_cast<uint8_t>(second_of_day / 3600);
+    time.Minutes = static_cast<uint8_t>(second_of_day / 60 % 60);
+    time.Seconds = static_cast<uint8_t>(second_of_day % 60);
+    time.SubSeconds = time.SecondFraction - ms * (time.SecondFraction + 1U) / 1000U;
+  }
+
+  static_assert(days_from_civil(1970, 1, 1) == 0);
+  static_assert(days_from_civil(2000, 1, 1) == 10957);
+  static_assert(days_from_civil(2000, 3, 1) == 11017);
+  static_assert(days_from_civil(2099, 12, 31) == 47481);
+  static_assert(days_from_civil(1969, 12, 31) == -1);
+  static_assert(civil_from_days(11016).month == 2 && civil_from_days(11016).day == 29);
+  static_assert(civil_from_days(47481).year == 2099 && civil_from_days(47481).day == 31);
+  static_assert(weekday_from_days(0) == RTC_WEEKDAY_THURSDAY);
+  static_assert(weekday_from_days(-1) == RTC_WEEKDAY_WEDNESDAY);
+  static_assert(weekday_from_days(10957) == RTC_WEEKDAY_SATURDAY);
+  static_assert(weekday(2024, 5, 9) == RTC_WEEKDAY_THURSDAY);
+  static_assert(weekday(2000, 2, 29) == RTC_WEEKDAY_TUESDAY);
+  static_assert(milliseconds(255, 255) == 0);
+  static_assert(milliseconds(0, 255) == 996);
+  static_assert(milliseconds(256, 255) == -4);
+  static_assert(milliseconds(510, 255) == -997);
+
+  /**
+    * @brief  Checks the tables and weekday() against days_from_civil() for
+    *         every date the RTC can store.
+    */
+  constexpr bool check_calendar_tables()
+  {
+    for (uint32_t year = 0; year < rtc_years; ++year)
+    {
+      const int32_t full_year = rtc_base_year + static_cast<int32_t>(year);
+      const int32_t new_year = days_from_civil(full_year, 1, 1);
+      const int32_t next_new_year = days_from_civil(full_year + 1, 1, 1);
+
+      if ((next_new_year - new_year) != (tables.leap[year] ? 366 : 365))
+      {
+        return false;
+      }
+
+      for (uint32_t month = 1; month <= 12; ++month)
+      {
+        const uint32_t days = days_in_month(static_cast<uint8_t>(year), static_cast<uint8_t>(month));
+        const int32_t next_month = (month < 12) ? days_from_civil(full_year, month + 1, 1) : next_new_year;
+
+        if ((days_from_civil(full_year, month, 1) + static_cast<int32_t>(days)) != next_month)
+        {
+          return false;
+        }
+
+        for (uint32_t day = 1; day <= days; ++day)
+        {
+          RTC_DateTypeDef date = {};
+          date.Year = static_cast<uint8_t>(year);
+          date.Month = static_cast<uint8_t>(month);
+          date.Date = static_cast<uint8_t>(day);
+
+          const civil_date civil = civil_from_days(days_from_rtc(date));
+
+          if (!is_valid_date(date) || (weekday(date) != weekday_from_days(days_from_rtc(date))) ||
+              (day_of_year(date) != days_from_civil(full_year, month, day) - new_year + 1) ||
+              (civil.year != full_year) || (civil.month != month) || (civil.day != day))
+          {
+            return false;
+          }
+        }
+
+        RTC_DateTypeDef after_last = {};
+        after_last.Year = static_cast<uint8_t>(year);
+        after_last.Month = static_cast<uint8_t>(month);
+        after_last.Date = static_cast<uint8_t>(days + 1);
+
+        if (is_valid_date(after_last))
+        {
+          return false;
+        }
+      }
+    }
+
+    return true;
+  }
+
+  static_assert(check_calendar_tables(), "The calendar tables are wrong");
+}
@@ -0,0 +1,270 @@
+/**
+  ******************************************************************************
+  * @file           : rtc_cmd_parser.cpp
+  * @author         : Rusanov M.N.
+  ******************************************************************************
+  */
+
+#include "rtc_cmd_parser.h"
+#include <algorithm>
+#include <iterator>
+#include "tcm.h"
+
+namespace
+{
+  constexpr bool is_placeholder(const char c)
+  {
+    return (c >= 'a') && (c <= 'z');
+  }
+
+  constexpr size_t count_fields(const char* str)
+  {
+    size_t result = 0;
+    for (char prev = '\0'; *str != '\0'; prev = *str++)
+    {
+      if (is_placeholder(*str) && (*str != prev))
+      {
+        ++result;
+      }
+    }
+
+    return result;
+  }
+}
+
+static_assert(count_fields(rtc_cmd_parser::time_template.data) <= rtc_cmd_parser::max_args);
+static_assert(count_fields(rtc_cmd_parser::data_template.data) <= rtc_cmd_parser::max_args);
+static_assert(count_fields(rtc_cmd_parser::data_time_template.data) <= rtc_cmd_parser::max_args);
+
+/**
+  * @brief  Advances the parser by one received byte.
+  * @param  c : received byte.
+  * @param  result : filled in when the function returns true.
+  * @retval true if the command is complete or rejected (result.err != OK).
+  *         After a rejection the bytes are skipped up to the end of the command.
+  */
+ITCM_CODE bool rtc_cmd_parser::feed(const char c, cmd_info& result)
+{
+  if (f_state == state::SKIP)
+  {
+    if (is_cmd_end(c))
+    {
+      end_cmd(c);
+    }
+
+    return false;
+  }
+
+  if (!is_cmd_end(c) && (++f_length > max_msg_length))
+  {
+    return fail(cmd_err::SIZE_EXCEEDED, c, result);
+  }
+
+  if (f_state == state::KEYWORD)
+  {
+    return on_keyword(c, result);
+  }
+
+  return on_arg(c, result);
+}
+
+void rtc_cmd_parser::reset()
+{
+  f_state = state::KEYWORD;
+  f_frame = false;
+  f_length = 0;
+  f_keyword_length = 0;
+  f_prefix = cmd_table_t::all_keywords;
+  f_hasher = cmd_table_t::hasher();
+  f_cmd = rtc_cmd::NONE;
+  f_template = "";
+  f_field = 0;
+  f_digits = 0;
+  f_max_digits = 0;
+
+  std::fill(std::begin(f_args), std::end(f_args), 0);
+}
+
+/**
+  * @retval true if no msg is being received, including the rest of the msg
+  *         after @ref cmd_separator.
+  */
+bool rtc_cmd_parser::is_idle() const
+{
+  return (f_state == state::KEYWORD) && (f_length == 0) && !f_frame;
+}
+
+/**
+  * @retval The keyword of the command, an empty string for NONE.
+  */
+const char* rtc_cmd_parser::keyword(const rtc_cmd cmd)
+{
+  const char* result = cmd_dispatch.keyword(cmd);
+  return (result != nullptr) ? result : "";
+}
+
+constexpr bool rtc_cmd_parser::is_cmd_end(const char c)
+{
+  return (c == end_char) || (c == cmd_separator);
+}
+
+/**
+  * @retval The template of the argument, an empty string if the command
+  *         has no argument.
+  */
+const char* rtc_cmd_parser::arg_template(const rtc_cmd cmd)
+{
+  switch (cmd)
+  {
+    case rtc_cmd::SET_T:
+      return time_template.data;
+    case rtc_cmd::SET_D:
+      return data_template.data;
+    case rtc_cmd::SET_DT:
+    case rtc_cmd::ALARM:
+      return data_time_template.data;
+    case rtc_cmd::SUBSCRIBE:
+      return period_template.data;
+    case rtc_cmd::ALARM_DEL:
+      return id_template.data;
+    default:
+      return "";
+  }
+}
+
+bool rtc_cmd_parser::on_keyword(const char c, cmd_info& result)
+{
+  if ((c != cmd_arg_separator) && !is_cmd_end(c))
+  {
+    if (!cmd_dispatch.extend(f_prefix, f_keyword_length, c))
+    {
+      return fail(cmd_err::WRONG_CMD, c, result);
+    }
+
+    f_keyword[f_keyword_length++] = c;
+    f_hasher.add(c);
+    return false;
+  }
+
+  if (is_cmd_end(c) && (f_keyword_length == 0))
+  {
+    end_cmd(c); // Empty msgs and commands are ignored
+    return false;
+  }
+
+  const rtc_cmd* cmd = cmd_dispatch.find(f_keyword, f_keyword_length, f_hasher.value());
+  const bool has_arg = (c == cmd_arg_separator);
+
+  if ((cmd == nullptr) || ((*arg_template(*cmd) != '\0') != has_arg))
+  {
+    return fail(cmd_err::WRONG_CMD, c, result);
+  }
+
+  f_cmd = *cmd;
+
+  if (!has_arg)
+  {
+    return complete(c, result);
+  }
+
+  f_state = state::ARG;
+  f_template = arg_template(f_cmd);
+  start_field();
+  return false;
+}
+
+/**
+  * @note   Each run of the same letter in the template is a decimal field of
+  *         1 up to run length digits, leading spaces of a field are skipped.
+  *         A field exceeding UINT16_MAX is rejected, not wrapped.
+  *         Other chars of the template must match exactly.
+  */
+bool rtc_cmd_parser::on_arg(const char c, cmd_info& result)
+{
+  if ((c >= '0') && (c <= '9'))
+  {
+    const uint32_t value = f_args[f_field] * 10U + static_cast<uint32_t>(c - '0');
+
+    if ((f_digits >= f_max_digits) || (value > UINT16_MAX))
+    {
+      return fail(cmd_err::WRONG_FORMAT, c, result);
+    }
+
+    f_args[f_field] = static_cast<uint16_t>(value);
+    ++f_digits;
+    return false;
+  }
+
+  if ((c == ' ') && (f_digits == 0))
+  {
+    return false;
+  }
+
+  if (f_digits == 0)
+  {
+    return fail(cmd_err::WRONG_FORMAT, c, result);
+  }
+
+  f_template += f_max_digits; // The field is complete
+
+  if (is_cmd_end(c))
+  {
+    return (*f_template == '\0') ? complete(c, result) : fail(cmd_err::WRONG_FORMAT, c, result);
+  }
+
+  if ((*f_template == '\0') || (*f_template != c))
+  {
+    return fail(cmd_err::WRONG_FORMAT, c, result);
+  }
+
+  ++f_template;
+  ++f_field;
+  start_field();
+  return false;
+}
+
+void rtc_cmd_parser::start_field()
+{
+  f_digits = 0;
+  f_max_digits = 0;
+
+  while (is_placeholder(f_template[f_max_digits]) && (f_template[f_max_digits] == f_template[0]))
+  {
+    ++f_max_digits;
+  }
+}
+
+/**
+  * @brief  Prepares the parser for the next command of the msg, if any.
+  * @param  c : the char which has ended the command.
+  */
+void rtc_cmd_parser::end_cmd(const char c)
+{
+  reset();
+  f_frame = (c == cmd_separator);
+}
+
+bool rtc_cmd_parser::complete(const char c, cmd_info& result)
+{
+  result = { f_cmd, cmd_err::OK, {} };
+  std::copy(std::begin(f_args), std::end(f_args), result.args);
+  end_cmd(c);
+  return true;
+}
+
+bool rtc_cmd_parser::fail(const cmd_err err, const char c, cmd_info& result)
+{
+  result = { f_cmd, err, {} };
+
+  if (is_cmd_end(c))
+  {
+    end_cmd(c);
+  }
+  else
+  {
+    reset();
+    f_state = state::SKIP;
+  }
+
+  return true;
+}
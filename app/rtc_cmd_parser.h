@@ -0,0 +1,170 @@
+/**
+  ******************************************************************************
+  * @file           : rtc_cmd_parser.h
+  * @author         : Rusanov M.N.
+  * @version        : V1.0.0
+  * @date           : 16-Oct-2026
+  * @brief          : Header for rtc_cmd_parser.cpp file.
+  *                   Streaming parser of the rtc_internal commands. The state
+  *                   machine advances on every received byte, so the msg is
+  *                   never buffered, the time/date fields are built on the fly
+  *                   and a wrong msg is rejected on its first wrong byte.
+  *                   One msg may hold several commands separated by
+  *                   @ref cmd_separator, each of them is reported separately.
+  *                   A command must end right after its argument, or its
+  *                   keyword if it has none: trailing text rejects it.
+  *                   The sscanf() parsing replaced by it ignored the text
+  *                   after the SET_T/SET_D fields, "GET" with any trailing
+  *                   text (even a space) has always been rejected.
+  * @note           : The parser doesn't depend on the HAL, it is tested on
+  *                   the host by test/rtc_cmd_parser_test.cpp.
+  *
+  ******************************************************************************
+  */
+
+#pragma once
+
+#include <cstdint>
+#include "static_string.h"
+#include "cmd_table.h"
+
+class rtc_cmd_parser
+{
+public:
+  enum class rtc_cmd : uint8_t
+  {
+    SET_T,
+    SET_D,
+    SET_DT,
+    GET,
+    GET_MS,
+    GET_WD,
+    GET_EPOCH,
+    SUBSCRIBE,
+    UNSUBSCRIBE,
+    ALARM,
+    ALARM_DEL,
+    DUMP_TS,
+    GET_ERR,
+    STACK,
+    STATS,
+    BOOT,
+    NONE
+  };
+
+  enum class cmd_err : uint8_t
+  {
+    OK,
+    WRONG_CMD,
+    WRONG_FORMAT,
+    SIZE_EXCEEDED
+  };
+
+  static constexpr size_t max_args = 6;
+
+  struct cmd_info
+  {
+    rtc_cmd cmd;
+    cmd_err err;
+    uint16_t args[max_args]; // Fields of the time/date in the order of the template
+  };
+
+  static constexpr char end_char = '\r';
+  static constexpr char cmd_separator = ';';
+  static constexpr char cmd_arg_separator = ' ';
+  static constexpr auto cmd_set_t = snw1::STOSS("SET_T");
+  static constexpr auto cmd_set_d = snw1::STOSS("SET_D");
+  static constexpr auto cmd_set_dt = snw1::STOSS("SET_DT");
+  static constexpr auto cmd_get = snw1::STOSS("GET");
+  static constexpr auto cmd_get_ms = snw1::STOSS("GET_MS");
+  static constexpr auto cmd_get_wd = snw1::STOSS("GET_WD");
+  static constexpr auto cmd_get_epoch = snw1::STOSS("GET_EPOCH");
+  static constexpr auto cmd_subscribe = snw1::STOSS("SUBSCRIBE");
+  static constexpr auto cmd_unsubscribe = snw1::STOSS("UNSUBSCRIBE");
+  static constexpr auto cmd_alarm = snw1::STOSS("ALARM");
+  static constexpr auto cmd_alarm_del = snw1::STOSS("ALARM_DEL");
+  static constexpr auto cmd_dump_ts = snw1::STOSS("DUMP_TS");
+  static constexpr auto cmd_get_err = snw1::STOSS("GET_ERR");
+  static constexpr auto cmd_stack = snw1::STOSS("STACK");
+  static constexpr auto cmd_stats = snw1::STOSS("STATS");
+  static constexpr auto cmd_boot = snw1::STOSS("BOOT");
+  static constexpr auto time_template = snw1::STOSS("hh:mm:ss");
+  static constexpr auto data_template = snw1::STOSS("dd/mm/yyyy");
+  static constexpr auto data_time_template = snw1::STOSS("dd/mm/yyyy hh:mm:ss");
+  static constexpr auto period_template = snw1::STOSS("ppppp"); // Milliseconds
+  static constexpr auto id_template = snw1::STOSS("iiiii");
+  static constexpr size_t max_msg_length = snw1::max<cmd_set_t.length() + 1 + time_template.length(),
+                                                     cmd_set_d.length() + 1 + data_template.length(),
+                                                     cmd_set_dt.length() + 1 + data_time_template.length(),
+                                                     cmd_get.length(),
+                                                     cmd_get_ms.length(),
+                                                     cmd_get_wd.length(),
+                                                     cmd_get_epoch.length(),
+                                                     cmd_subscribe.length() + 1 + period_template.length(),
+                                                     cmd_unsubscribe.length(),
+                                                     cmd_alarm.length() + 1 + data_time_template.length(),
+                                                     cmd_alarm_del.length() + 1 + id_template.length(),
+                                                     cmd_dump_ts.length(),
+                                                     cmd_get_err.length(),
+                                                     cmd_stack.length(),
+                                                     cmd_stats.length(),
+                                                     cmd_boot.length()>();
+
+  [[nodiscard]] bool feed(char c, cmd_info& result);
+  void reset();
+  [[nodiscard]] bool is_idle() const;
+  [[nodiscard]] static const char* keyword(rtc_cmd cmd);
+
+private:
+  enum class state : uint8_t
+  {
+    KEYWORD, // Receiving the command keyword
+    ARG,     // Receiving the fields of the argument
+    SKIP     // The msg is rejected, waiting for its end
+  };
+
+  using cmd_table_t = cmd_table<rtc_cmd, 16>;
+  static constexpr cmd_table_t cmd_dispatch{ {
+    cmd_table_t::make_entry(cmd_set_t, rtc_cmd::SET_T),
+    cmd_table_t::make_entry(cmd_set_d, rtc_cmd::SET_D),
+    cmd_table_t::make_entry(cmd_set_dt, rtc_cmd::SET_DT),
+    cmd_table_t::make_entry(cmd_get, rtc_cmd::GET),
+    cmd_table_t::make_entry(cmd_get_ms, rtc_cmd::GET_MS),
+    cmd_table_t::make_entry(cmd_get_wd, rtc_cmd::GET_WD),
+    cmd_table_t::make_entry(cmd_get_epoch, rtc_cmd::GET_EPOCH),
+    cmd_table_t::make_entry(cmd_subscribe, rtc_cmd::SUBSCRIBE),
+    cmd_table_t::make_entry(cmd_unsubscribe, rtc_cmd::UNSUBSCRIBE),
+    cmd_table_t::make_entry(cmd_alarm, rtc_cmd::ALARM),
+    cmd_table_t::make_entry(cmd_alarm_del, rtc_cmd::ALARM_DEL),
+    cmd_table_t::make_entry(cmd_dump_ts, rtc_cmd::DUMP_TS),
+    cmd_table_t::make_entry(cmd_get_err, rtc_cmd::GET_ERR),
+    cmd_table_t::make_entry(cmd_stack, rtc_cmd::STACK),
+    cmd_table_t::make_entry(cmd_stats, rtc_cmd::STATS),
+    cmd_table_t::make_entry(cmd_boot, rtc_cmd::BOOT)
+  } };
+  static_assert(cmd_dispatch.is_valid(), "No perfect hash for the command keywords");
+
+  [[nodiscard]] static const char* arg_template(rtc_cmd cmd);
+  [[nodiscard]] bool on_keyword(char c, cmd_info& result);
+  [[nodiscard]] bool on_arg(char c, cmd_info& result);
+  [[nodiscard]] static constexpr bool is_cmd_end(char c);
+  [[nodiscard]] bool complete(char c, cmd_info& result);
+  [[nodiscard]] bool fail(cmd_err err, char c, cmd_info& result);
+  void start_field();
+  void end_cmd(char c);
+
+private:
+  state f_state = state::KEYWORD;
+  bool f_frame = false; // The msg continues after @ref cmd_separator
+  size_t f_length = 0;  // Number of bytes of the command received so far
+  char f_keyword[cmd_table_t::max_length] = { '\0' };
+  size_t f_keyword_length = 0;
+  cmd_table_t::prefix f_prefix = cmd_table_t::all_keywords; // Keywords starting with the received chars
+  cmd_table_t::hasher f_hasher;
+  rtc_cmd f_cmd = rtc_cmd::NONE;
+  const char* f_template = ""; // Position in the template of the argument
+  size_t f_field = 0;
+  size_t f_digits = 0;
+  size_t f_max_digits = 0;
+  uint16_t f_args[max_args] = { 0 };
+};
@@ -0,0 +1,218 @@
+/**
+  ******************************************************************************
+  * @file           : rtc_drift.cpp
+  * @author         : Rusanov M.N.
+  ******************************************************************************
+  */
+
+#include "rtc_drift.h"
+#include "rtc_backup.h"
+#include <algorithm>
+#include <cmath>
+
+extern RTC_HandleTypeDef hrtc;
+
+rtc_drift::rtc_drift() = default;
+
+rtc_drift& rtc_drift::get_instance()
+{
+  static rtc_drift instance;
+  return instance;
+}
+
+/**
+  * @brief  Restores the model from @ref rtc_backup::store and programs
+  *         the calibration of the model.
+  * @note   The store must be valid, see @ref rtc_internal::init().
+  */
+HAL_StatusTypeDef rtc_drift::init()
+{
+  f_calibration_pulses = rtc_backup::store::get<rtc_backup::drift_calibration>();
+  f_size = std::min<size_t>(rtc_backup::store::get<rtc_backup::drift_size>(), max_samples);
+  f_samples = rtc_backup::store::get<rtc_backup::drift_samples>();
+
+  // CALR survives the reset too, programming it waits for the next calibration cycle
+  if (hrtc.Instance->CALR == calibration_register(f_calibration_pulses))
+  {
+    return HAL_OK;
+  }
+
+  return calibrate(f_calibration_pulses);
+}
+
+/**
+  * @brief  Records the correction and recalibrates the RTC when the fit is ready.
+  * @param  epoch_s : true time of the correction, seconds since 01/01/1970.
+  * @param  delta_ms : true time minus the RTC time.
+  * @note   The first correction and a correction too large to be a drift
+  *         (the time has been set by hand) start the model from scratch.
+  */
+HAL_StatusTypeDef rtc_drift::add_correction(const int64_t epoch_s, const int64_t delta_ms)
+{
+  const auto now_s = static_cast<uint32_t>(epoch_s);
+
+  if (f_size == 0)
+  {
+    restart(now_s);
+    return HAL_OK;
+  }
+
+  const sample& last = f_samples[f_size - 1];
+  const int64_t elapsed_s = static_cast<int64_t>(now_s) - last.epoch_s;
+  const int64_t max_delta_ms = elapsed_s * max_drift_ppm / 1000 + 1000;
+
+  if ((elapsed_s <= 0) || (std::abs(delta_ms) > max_delta_ms))
+  {
+    restart(now_s);
+    return HAL_OK;
+  }
+
+  if (f_size == max_samples)
+  {
+    std::copy(f_samples.begin() + 1, f_samples.end(), f_samples.begin());
+    --f_size;
+  }
+
+  f_samples[f_size] = { now_s, f_samples[f_size - 1].offset_ms + static_cast<int32_t>(delta_ms) };
+  ++f_size;
+
+  if (!fit_ready())
+  {
+    save();
+    return HAL_OK;
+  }
+
+  // The samples measure the drift left by the current calibration
+  const int32_t pulses = std::clamp(f_calibration_pulses + fit_pulses(), -511, 512);
+  restart(now_s);
+  return calibrate(pulses);
+}
+
+/**
+  * @brief  Drops the corrections, the calibration is kept. Must be called
+  *         when the date has been set: the time axis of the fit has jumped.
+  */
+void rtc_drift::reset()
+{
+  f_size = 0;
+  save();
+}
+
+/**
+  * @brief  Shifts the calendar by less than one second without stopping it.
+  * @param  delta_ms : -999...999 ms, > 0 advances the calendar.
+  * @note   The shift adds one second and/or delays the calendar by a number
+  *         of sub-second ticks, 1/(PREDIV_S + 1) s each.
+  */
+HAL_StatusTypeDef rtc_drift::shift(const int32_t delta_ms)
+{
+  if ((delta_ms == 0) || (std::abs(delta_ms) > max_shift_ms))
+  {
+    return (delta_ms == 0) ? HAL_OK : HAL_ERROR;
+  }
+
+  const uint32_t ticks_per_s = (hrtc.Instance->PRER & RTC_PRER_PREDIV_S) + 1;
+  const uint32_t delay_ms = (delta_ms > 0) ? static_cast<uint32_t>(1000 - delta_ms) : static_cast<uint32_t>(-delta_ms);
+  const uint32_t delay_ticks = (delay_ms * ticks_per_s + 500) / 1000;
+
+  return HAL_RTCEx_SetSynchroShift(&hrtc,
+                                   (delta_ms > 0) ? RTC_SHIFTADD1S_SET : RTC_SHIFTADD1S_RESET,
+                                   std::min<uint32_t>(delay_ticks, ticks_per_s - 1));
+}
+
+/**
+  * @retval RTCCLK pulses added (> 0) or masked (< 0) every 2^20 pulses,
+  *         1 pulse is 0.954 ppm.
+  */
+int32_t rtc_drift::calibration_pulses() const
+{
+  return f_calibration_pulses;
+}
+
+/**
+  * @retval Number of corrections in the current fit.
+  */
+size_t rtc_drift::size() const
+{
+  return f_size;
+}
+
+void rtc_drift::restart(const uint32_t epoch_s)
+{
+  f_samples[0] = { epoch_s, 0 };
+  f_size = 1;
+  save();
+}
+
+bool rtc_drift::fit_ready() const
+{
+  return (f_size >= min_fit_samples) && (f_samples[f_size - 1].epoch_s - f_samples[0].epoch_s >= min_fit_span_s);
+}
+
+/**
+  * @retval Slope of the least-squares line of the cumulative corrections
+  *         in calibration pulses.
+  * @note   The sums are exact in integers, relative to the first sample.
+  */
+int32_t rtc_drift::fit_pulses() const
+{
+  const auto n = static_cast<int64_t>(f_size);
+  int64_t sx = 0;
+  int64_t sy = 0;
+  int64_t sxx = 0;
+  int64_t sxy = 0;
+
+  for (size_t i = 0; i < f_size; ++i)
+  {
+    const int64_t x = f_samples[i].epoch_s - f_samples[0].epoch_s;
+    const int64_t y = f_samples[i].offset_ms;
+    sx += x;
+    sy += y;
+    sxx += x * x;
+    sxy += x * y;
+  }
+
+  const int64_t den = n * sxx - sx * sx;
+  if (den == 0)
+  {
+    return 0;
+  }
+
+  // ms/s to pulses per 2^20: ppm = slope * 1000, pulses = ppm * 2^20 / 10^6
+  const float slope = static_cast<float>(n * sxy - sx * sy) / static_cast<float>(den);
+  return static_cast<int32_t>(std::lround(slope * static_cast<float>(calibration_period_pulses) / 1000.0F));
+}
+
+/**
+  * @param  pulses : -511...512, see @ref calibration_pulses().
+  */
+HAL_StatusTypeDef rtc_drift::calibrate(const int32_t pulses)
+{
+  const uint32_t calr = calibration_register(pulses);
+  const auto status = HAL_RTCEx_SetSmoothCalib(&hrtc, RTC_SMOOTHCALIB_PERIOD_32SEC,
+                                               calr & RTC_CALR_CALP, calr & RTC_CALR_CALM);
+
+  if (status == HAL_OK)
+  {
+    f_calibration_pulses = pulses;
+    save();
+  }
+
+  return status;
+}
+
+/**
+  * @retval RTC_CALR value of the 32 s calibration cycle for the pulses.
+  */
+constexpr uint32_t rtc_drift::calibration_register(const int32_t pulses)
+{
+  return (pulses > 0) ? (RTC_SMOOTHCALIB_PLUSPULSES_SET | static_cast<uint32_t>(512 - pulses)) :
+                        static_cast<uint32_t>(-pulses);
+}
+
+void rtc_drift::save() const
+{
+  rtc_backup::store::set<rtc_backup::drift_calibration>(f_calibration_pulses);
+  rtc_backup::store::set<rtc_backup::drift_size>(f_size);
+  rtc_backup::store::set<rtc_backup::drift_samples>(f_samples);
+}
@@ -0,0 +1,65 @@
+/**
+  ******************************************************************************
+  * @file           : rtc_drift.h
+  * @author         : Rusanov M.N.
+  * @version        : V1.0.0
+  * @date           : 16-Oct-2026
+  * @brief          : Header for rtc_drift.cpp file.
+  *                   Estimation of the RTC drift from the time corrections sent
+  *                   by the host. The corrections are accumulated against the
+  *                   true time, the drift is the slope of their least-squares
+  *                   line. Once the fit spans long enough, the drift is
+  *                   compensated by the RTC smooth calibration.
+  * @note           : The model is kept in @ref rtc_backup::store, so it
+  *                   survives the reset as long as the backup domain is powered.
+  *
+  ******************************************************************************
+  */
+
+#pragma once
+
+#include <array>
+#include "main.h"
+
+class rtc_drift
+{
+public:
+  static constexpr size_t max_samples = 8;
+  static constexpr size_t min_fit_samples = 3;
+  static constexpr uint32_t min_fit_span_s = 24 * 3600; // The host sets the time to 1 s
+  static constexpr int32_t max_drift_ppm = 488;          // Range of the smooth calibration
+  static constexpr int32_t max_shift_ms = 999;           // Corrections applied by the shift
+
+  // Cumulative correction at the true time of the correction
+  struct sample
+  {
+    uint32_t epoch_s;
+    int32_t offset_ms;
+  };
+
+  using samples = std::array<sample, max_samples>;
+
+  [[nodiscard]] static rtc_drift& get_instance();
+  [[nodiscard]] HAL_StatusTypeDef init();
+  [[nodiscard]] HAL_StatusTypeDef add_correction(int64_t epoch_s, int64_t delta_ms);
+  void reset();
+  [[nodiscard]] static HAL_StatusTypeDef shift(int32_t delta_ms);
+  [[nodiscard]] int32_t calibration_pulses() const;
+  [[nodiscard]] size_t size() const;
+
+private:
+  static constexpr int32_t calibration_period_pulses = 1 << 20; // 32 s at 32768 Hz
+
+  explicit rtc_drift();
+  void restart(uint32_t epoch_s);
+  [[nodiscard]] bool fit_ready() const;
+  [[nodiscard]] int32_t fit_pulses() const;
+  [[nodiscard]] HAL_StatusTypeDef calibrate(int32_t pulses);
+  [[nodiscard]] static constexpr uint32_t calibration_register(int32_t pulses);
+  void save() const;
+
+private:
+  samples f_samples = {};
+  size_t f_size = 0;
+  int32_t f_calibration_pulses = 0; // > 0: the RTC is sped up
+};
@@ -7,12 +7,24 @@
 
 #include "rtc_internal.h"
 #include <algorithm>
-#include <cstring>
-#include <cstdio>
 #include "xprintf.h"
+#include "xuart_stream.h"
+#include "rtc_snapshot.h"
+#include "rtc_calendar.h"
+#include "irq_lock.h"
+#include "rtc_alarms.h"
+#include "rtc_timestamps.h"
+#include "rtc_drift.h"
+#include "rtc_backup.h"
+#include "stack_monitor.h"
+#include "cycle_profile.h"
+#include "boot_profile.h"
+#include "tcm.h"
 
 extern RTC_HandleTypeDef hrtc;
 
+DTCM_BSS volatile uint8_t rtc_internal::f_rx_dma_buf[rtc_internal::rx_dma_buf_size];
+
 rtc_internal::rtc_internal() = default;
 
 rtc_internal& rtc_internal::get_instance()
@@ -21,38 +33,69 @@ rtc_internal& rtc_internal::get_instance()
   return instance;
 }
 
-void rtc_internal::init(UART_HandleTypeDef& huart)
+/**
+  * @brief  Starts answering the commands.
+  * @param  prescaler : @ref rtc_prescaler::DEFAULT keeps the prescalers of MX_RTC_Init().
+  * @note   @ref start_epoch_clock() must be called next, it may be deferred:
+  *         @ref epoch_ms() computes the seconds from scratch meanwhile.
+  */
+void rtc_internal::init(UART_HandleTypeDef& huart, const rtc_prescaler prescaler)
 {
+  if ((prescaler != rtc_prescaler::DEFAULT) && (set_prescaler(prescaler) != HAL_OK))
+  {
+    Error_Handler();
+  }
+
+  if (!rtc_backup::store::is_valid())
+  {
+    rtc_backup::store::reset();
+  }
+
+  if (rtc_drift::get_instance().init() != HAL_OK)
+  {
+    Error_Handler();
+  }
+
   f_huart = &huart;
-  f_max_reception_time_ms = (rx_buf_size * (1 + 8 + 2) * 1000 / huart.Init.BaudRate + 2) * 3;
+  f_max_reception_time_ms = (max_frame_cmds * (rtc_cmd_parser::max_msg_length + 1) * (1 + 8 + 2) * 1000 / huart.Init.BaudRate + 2) * 3;
   start_receive_msg();
 }
 
+/**
+  * @brief  Starts the USART RX DMA in circular mode with the idle line interrupt.
+  * @note   The bytes are processed by @ref process_rx_dma() on DMA half/full transfer
+  *         and on idle line, so the interrupt is generated once per frame, not per byte.
+  */
 void rtc_internal::initiate_reception()
 {
-  HAL_UART_Receive_IT(f_huart, const_cast<uint8_t*>(&f_rx_buf[f_rx_buf_index]), sizeof(f_rx_buf[0]));
+  f_rx_dma.reset();
+
+  if (HAL_UART_Receive_DMA(f_huart, const_cast<uint8_t*>(f_rx_dma_buf), rx_dma_buf_size) != HAL_OK)
+  {
+    Error_Handler();
+  }
+
+  __HAL_UART_CLEAR_IDLEFLAG(f_huart);
+  __HAL_UART_ENABLE_IT(f_huart, UART_IT_IDLE);
 }
 
 void rtc_internal::start_receive_msg()
 {
-  f_rx_buf_index = 0;
+  f_parser.reset();
+  f_rx_time_out = false;
   initiate_reception();
 }
 
-void rtc_internal::restart_msg_reception()
-{
-  HAL_UART_AbortReceive_IT(f_huart);
-  start_receive_msg();
-}
-
 /**
   * @brief Must be called in the SysTick_Handler() interrupt handler with
   *        a period of 1 ms.
+  * @note  The parser belongs to the USART interrupt, so the msg is discarded
+  *        there on the next received byte.
   */
 void rtc_internal::check_time_out_reception()
 {
   static uint32_t time_out = 0;
-  if (f_rx_buf_index == 0)
+  if (f_rx_time_out || f_parser.is_idle())
   {
     time_out = 0; 
   }
@@ -61,9 +104,9 @@ void rtc_internal::check_time_out_reception()
     ++time_out;
     if (time_out >= f_max_reception_time_ms) 
     {
-      xprintf("Error: Timeout command!\r");
+      f_err_time_out.occurred = f_err_time_out.occurred + 1;
       time_out = 0;
-      restart_msg_reception();
+      f_rx_time_out = true;
     }
   }
 }
@@ -73,272 +116,849 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef* huart)
   rtc_internal::get_instance().uart_rx_cplt_callback(huart);
 }
 
+void HAL_UART_RxHalfCpltCallback(UART_HandleTypeDef* huart)
+{
+  rtc_internal::get_instance().uart_rx_cplt_callback(huart);
+}
+
+/**
+  * @brief  Called on DMA half transfer and transfer complete (buffer wrap).
+  */
 void rtc_internal::uart_rx_cplt_callback(const UART_HandleTypeDef* huart)
 {
   if (huart == f_huart)
   {
-    forming_rx_msg();
+    process_rx_dma();
   }
 }
 
-void rtc_internal::forming_rx_msg()
+/**
+  * @brief  Must be called in the USARTx_IRQHandler() interrupt handler
+  *         when the idle line flag is set.
+  */
+void rtc_internal::uart_idle_callback(const UART_HandleTypeDef* huart)
 {
-  if (f_rx_buf[f_rx_buf_index] != '\r')
+  if (huart == f_huart)
   {
-    f_rx_buf_index = f_rx_buf_index + 1;
+    process_rx_dma();
+  }
+}
 
-    if (f_rx_buf_index >= rx_buf_size)
-    {
-      xprintf("Error: Msg size exceeded!\r");
-      restart_msg_reception();
-      return;
-    }
+/**
+  * @brief  Must be called in the HAL_UART_ErrorCallback().
+  *         The HAL aborts the DMA reception on the overrun/framing/noise errors,
+  *         so the reception is restarted from scratch.
+  */
+void rtc_internal::uart_error_callback(const UART_HandleTypeDef* huart)
+{
+  if (huart == f_huart)
+  {
+    HAL_UART_AbortReceive(f_huart);
+    start_receive_msg();
   }
-  else
+}
+
+/**
+  * @brief  Passes all bytes written by DMA since the last call to the msg former.
+  * @note   The position arithmetic is in @ref rx_dma_reader, tested on the host.
+  */
+ITCM_CODE void rtc_internal::process_rx_dma()
+{
+  f_rx_dma.read(f_rx_dma_buf, __HAL_DMA_GET_COUNTER(f_huart->hdmarx),
+                [this](const uint8_t c) { forming_rx_msg(c); });
+}
+
+/**
+  * @brief  Feeds the byte to the command parser and pushes the parsed command
+  *         or the parsing error to the queue.
+  * @note   The commands are never executed here: this is the interrupt context.
+  */
+ITCM_CODE void rtc_internal::forming_rx_msg(const uint8_t c)
+{
+  static_assert(parse_probe_slot < cycle_profile::max_slots, "No cycle_profile slot for the parser");
+  CYCLE_PROBE(parse_probe_slot, "parse byte");
+
+  if (f_rx_time_out)
+  {
+    f_parser.reset();
+    f_rx_time_out = false;
+  }
+
+  if (cmd_info result; f_parser.feed(static_cast<char>(c), result))
   {
-    if (f_rx_msg[0] != '\0') // If msg hasn't been parsed to this point.
+    if (!f_rx_queue.push(result))
     {
-      execute_cmd(parse_received_msg()); // Start the parser forced!
+      f_err_queue_full.occurred = f_err_queue_full.occurred + 1;
     }
+  }
+}
 
-    std::copy_n(f_rx_buf, f_rx_buf_index, f_rx_msg);
-    f_rx_msg[f_rx_buf_index] = '\0';
-    f_rx_buf_index = 0;
+/**
+  * @brief  This function must be called in the main loop.
+  * @note   Reports the reception errors and executes all queued commands in order.
+  *         The replies to the commands of one msg are sent in one transmission
+  *         when its last command has been executed.
+  */
+void rtc_internal::process_received_msgs()
+{
+  // Read before the queue is drained: all commands of the completed msg are queued already
+  const bool msg_complete = f_rx_time_out || f_parser.is_idle();
+
+  if (!f_tx_batch && (f_rx_queue.front() != nullptr))
+  {
+    xuart_stream::get_instance().begin_batch();
+    f_tx_batch = true;
   }
 
-  initiate_reception();
+  rtc_backup::store::add<rtc_backup::rx_time_outs>(report_rx_error(f_err_time_out, "Error: Timeout command!\r"));
+  rtc_backup::store::add<rtc_backup::rx_queue_overflows>(report_rx_error(f_err_queue_full, "Error: Command queue is full!\r"));
+
+  while (const cmd_info* cmd = f_rx_queue.front())
+  {
+    execute_cmd(*cmd);
+    f_rx_queue.pop();
+  }
+
+  print_samples();
+
+  if (f_tx_batch && msg_complete)
+  {
+    xuart_stream::get_instance().end_batch();
+    f_tx_batch = false;
+  }
+}
+
+size_t rtc_internal::queue_depth() const
+{
+  return f_rx_queue.size();
+}
+
+size_t rtc_internal::queue_high_water() const
+{
+  return f_rx_queue.high_water();
 }
 
 /**
-  * @brief  This function must be called in the main loop to parse received msg.
-  * @note   This function parses msg received by UART into rtc_cmd and time/data str.
-  * @retval The command of rtc_cmd and pointer to string of format @ref time_template
-  *         or @ref data_template with result of time/data (ptr to location in the @ref f_rx_msg).
+  * @retval Number of the errors reported.
   */
-rtc_internal::cmd_info rtc_internal::parse_received_msg()
+uint32_t rtc_internal::report_rx_error(rx_error& err, const char* msg)
 {
-  cmd_info result = { rtc_cmd::NONE, "" };
+  uint32_t count = 0;
 
-  if (f_rx_msg[0] != '\0')
+  while (err.reported != err.occurred)
   {
-    if (std::strncmp(const_cast<const char*>(f_rx_msg), cmd_set_t.c_str(), cmd_set_t.length()) == 0)
-    {
-      result = { rtc_cmd::SET_T, const_cast<const char*>(f_rx_msg) + cmd_set_d.length() };
-    }
-    else if (std::strncmp(const_cast<const char*>(f_rx_msg), cmd_set_d.c_str(), cmd_set_d.length()) == 0)
-    {
-      result = { rtc_cmd::SET_D, const_cast<const char*>(f_rx_msg) + cmd_set_d.length() };
-    }
-    else if (std::strncmp(const_cast<const char*>(f_rx_msg), cmd_get.c_str(), cmd_get.length()) == 0)
-    {
-      if (f_rx_msg[cmd_get.length()] == '\0')
-      {
-        result.cmd = rtc_cmd::GET;
-      }
-      else
-      {
-        xprintf("Error: Wrong command!\r");
-      }
-    }
-    else
-    {
-      xprintf("Error: Wrong command!\r");
-    }
-
-    f_rx_msg[0] = '\0';
+    xprintf(msg);
+    ++err.reported;
+    ++count;
   }
 
-  return result;
+  return count;
 }
 
+/**
+  * @brief  Executes the parsed command or reports the parsing error.
+  */
 void rtc_internal::execute_cmd(const cmd_info& data)
 {
+  switch (data.err)
+  {
+    case cmd_err::OK:
+      break;
+    case cmd_err::WRONG_CMD:
+      xprintf("Error: Wrong command!\r");
+      return;
+    case cmd_err::WRONG_FORMAT:
+      report_wrong_format(data.cmd);
+      return;
+    case cmd_err::SIZE_EXCEEDED:
+      xprintf("Error: Msg size exceeded!\r");
+      return;
+  }
+
+  const auto arg = [&data](const size_t index) { return static_cast<uint8_t>(data.args[index]); };
+  CYCLE_PROBE(static_cast<size_t>(data.cmd), rtc_cmd_parser::keyword(data.cmd));
+
   switch (data.cmd)
   {
     case rtc_cmd::SET_T:
-      set_time(data.res_str);
+      set_time(arg(0), arg(1), arg(2));
       break;
     case rtc_cmd::SET_D:
-      set_date(data.res_str);
+      set_date(arg(0), arg(1), data.args[2]);
+      break;
+    case rtc_cmd::SET_DT:
+      set_date_time(arg(0), arg(1), data.args[2], arg(3), arg(4), arg(5));
       break;
     case rtc_cmd::GET:
       print_time();
       break;
+    case rtc_cmd::GET_MS:
+      print_time_ms();
+      break;
+    case rtc_cmd::GET_WD:
+      print_time_weekday();
+      break;
+    case rtc_cmd::GET_EPOCH:
+      print_epoch();
+      break;
+    case rtc_cmd::SUBSCRIBE:
+      if ((data.args[0] < min_period_ms) || (data.args[0] > max_period_ms))
+      {
+        xprintf("Error: Wrong period! Must be %u...%u ms\r", min_period_ms, max_period_ms);
+      }
+      else if (const auto res = subscribe(data.args[0]); res != HAL_OK)
+      {
+        xprintf("Error %u: Failed to subscribe!\r", res);
+      }
+      break;
+    case rtc_cmd::UNSUBSCRIBE:
+      if (const auto res = unsubscribe(); res != HAL_OK)
+      {
+        xprintf("Error %u: Failed to unsubscribe!\r", res);
+      }
+      break;
+    case rtc_cmd::ALARM:
+      add_alarm(arg(0), arg(1), data.args[2], arg(3), arg(4), arg(5));
+      break;
+    case rtc_cmd::ALARM_DEL:
+      if (!rtc_alarms::get_instance().cancel(data.args[0]))
+      {
+        xprintf("Error: No alarm %u!\r", data.args[0]);
+      }
+      break;
+    case rtc_cmd::DUMP_TS:
+      rtc_timestamps::get_instance().dump();
+      break;
+    case rtc_cmd::GET_ERR:
+      print_error_counters();
+      break;
+    case rtc_cmd::STACK:
+      stack_monitor::get_instance().report();
+      break;
+    case rtc_cmd::STATS:
+      cycle_profile::get_instance().report();
+      break;
+    case rtc_cmd::BOOT:
+      boot_profile::get_instance().report();
+      print_cache_cycles();
+      break;
     case rtc_cmd::NONE:
       break;
   }
 }
 
+void rtc_internal::report_wrong_format(const rtc_cmd cmd)
+{
+  switch (cmd)
+  {
+    case rtc_cmd::SET_T:
+      xprintf("Error: Wrong time format!\r");
+      break;
+    case rtc_cmd::SET_D:
+      xprintf("Error: Wrong data format!\r");
+      break;
+    case rtc_cmd::SUBSCRIBE:
+      xprintf("Error: Wrong period format!\r");
+      break;
+    case rtc_cmd::ALARM_DEL:
+      xprintf("Error: Wrong alarm id format!\r");
+      break;
+    default:
+      xprintf("Error: Wrong data and time format!\r");
+      break;
+  }
+}
+
 /**
   * @brief  Sets RTC current time.
-  * @param  str : pointer to string of format @ref time_template
+  * @param  hours, minutes, seconds : fields of @ref rtc_cmd_parser::time_template
+  * @note   See @ref correct_time(). Only a valid time is passed to the drift
+  *         estimation. The alarms are rescheduled, see
+  *         @ref rtc_alarms::calendar_changed().
   */
-void rtc_internal::set_time(const char* str)
+void rtc_internal::set_time(const uint8_t hours, const uint8_t minutes, const uint8_t seconds)
 {
-  unsigned int hours = 0;
-  unsigned int minutes = 0;
-  unsigned int seconds = 0;
+  RTC_TimeTypeDef time_set = make_time(hours, minutes, seconds);
+  const bool is_valid = (time_set.Hours == hours) && (time_set.Minutes == minutes) && (time_set.Seconds == seconds);
 
-  if (sscanf(str, "%2u:%2u:%2u", &hours, &minutes, &seconds) == 3) 
+  const rtc_snapshot snapshot = now();
+  const int64_t rtc_ms = rtc_calendar::to_epoch_ms(snapshot.date(), snapshot.time());
+  int64_t delta_ms = rtc_calendar::to_epoch_s(snapshot.date(), time_set) * 1000 - rtc_ms;
+
+  // Near midnight the time may belong to the adjacent day
+  constexpr int64_t day_ms = static_cast<int64_t>(rtc_calendar::seconds_per_day) * 1000;
+  if (delta_ms > day_ms / 2)
+  {
+    delta_ms -= day_ms;
+  }
+  else if (delta_ms < -day_ms / 2)
   {
-    RTC_TimeTypeDef time_set;
-    time_set.Hours = static_cast<uint8_t>(hours);
-    time_set.Minutes = static_cast<uint8_t>(minutes);
-    time_set.Seconds = static_cast<uint8_t>(seconds);
+    delta_ms += day_ms;
+  }
 
-    if (fix_time(time_set, true) != rtc_res::OK)
-    {
-      xprintf("Error: Wrong time! Maybe you mean: %02u:%02u:%02u?\r",
-        time_set.Hours,
-        time_set.Minutes,
-        time_set.Seconds);
-    }
+  if (is_valid)
+  {
+    add_drift_correction(rtc_ms, delta_ms); // A fixed time is not a measurement of the drift
+  }
 
+  if (!correct_time(delta_ms))
+  {
     if (const auto res = HAL_RTC_SetTime(&hrtc, &time_set, RTC_FORMAT_BIN); 
         res != HAL_OK)
     {
       xprintf("Error %u: Failed to set time!\r", res);
     }
   }
-  else 
-  {
-    xprintf("Error: Wrong time format!\r");
-  }
+
+  rtc_alarms::get_instance().calendar_changed();
 }
 
 /**
   * @brief  Sets RTC current date.
-  * @param  str : pointer to string of format @ref data_template
+  * @param  day, month, year : fields of @ref rtc_cmd_parser::data_template
+  * @note   The drift estimation is restarted, see @ref rtc_drift::reset().
+  *         The alarms are rescheduled, see @ref rtc_alarms::calendar_changed().
   */
-void rtc_internal::set_date(const char* str)
+void rtc_internal::set_date(const uint8_t day, const uint8_t month, const uint16_t year)
 {
-  unsigned int day = 0;
-  unsigned int month = 0;
-  unsigned int year = 0;
+  RTC_DateTypeDef date_set = make_date(day, month, year);
+  rtc_drift::get_instance().reset();
 
-  if (sscanf(str, "%2u/%2u/%4u", &day, &month, &year) == 3) 
+  if (const auto res = HAL_RTC_SetDate(&hrtc, &date_set, RTC_FORMAT_BIN); 
+      res != HAL_OK)
   {
-    RTC_DateTypeDef date_set;
-    date_set.Date = static_cast<uint8_t>(day);
-    date_set.Month = static_cast<uint8_t>(month);
-    date_set.Year = static_cast<uint8_t>(year % 100);
+    xprintf("Error %u: Failed to set data!\r", res);
+  }
 
-    if (fix_date(date_set, true) != rtc_res::OK)
-    {
-      xprintf("Error: Wrong date! Maybe you mean: %02u/%02u/%4u?\r",
-        date_set.Date,
-        date_set.Month,
-        static_cast<unsigned int>(date_set.Year) + 2000);
-    }
+  rtc_alarms::get_instance().calendar_changed();
+}
+
+/**
+  * @brief  Sets RTC current date and time at once.
+  * @param  day, month, year, hours, minutes, seconds : fields of
+  *         @ref rtc_cmd_parser::data_time_template
+  * @note   See @ref correct_time(), used only if DR already holds the date
+  *         and the week day. The drift estimation is restarted, see
+  *         @ref rtc_drift::reset(). The alarms are rescheduled, see
+  *         @ref rtc_alarms::calendar_changed().
+  */
+void rtc_internal::set_date_time(const uint8_t day, const uint8_t month, const uint16_t year,
+                                 const uint8_t hours, const uint8_t minutes, const uint8_t seconds)
+{
+  const RTC_DateTypeDef date_set = make_date(day, month, year);
+  const RTC_TimeTypeDef time_set = make_time(hours, minutes, seconds);
+
+  const rtc_snapshot snapshot = now();
+  const int64_t rtc_ms = rtc_calendar::to_epoch_ms(snapshot.date(), snapshot.time());
+
+  rtc_drift::get_instance().reset();
+
+  // A shift never rewrites DR: a wrong date or week day needs the full write
+  const bool same_date = ((snapshot.dr & RTC_DR_RESERVED_MASK) == make_dr(date_set));
 
-    if (const auto res = HAL_RTC_SetDate(&hrtc, &date_set, RTC_FORMAT_BIN); 
+  if (!same_date || !correct_time(rtc_calendar::to_epoch_s(date_set, time_set) * 1000 - rtc_ms))
+  {
+    if (const auto res = write_date_time(date_set, time_set);
         res != HAL_OK)
     {
-      xprintf("Error %u: Failed to set data!\r", res);
+      xprintf("Error %u: Failed to set data and time!\r", res);
     }
   }
-  else 
+
+  rtc_alarms::get_instance().calendar_changed();
+}
+
+/**
+  * @brief  Passes the correction of the host to the drift estimation.
+  * @param  rtc_ms : RTC time before the correction, ms since 01/01/1970.
+  * @param  delta_ms : true time minus the RTC time.
+  */
+void rtc_internal::add_drift_correction(const int64_t rtc_ms, const int64_t delta_ms)
+{
+  if (const auto res = rtc_drift::get_instance().add_correction((rtc_ms + delta_ms) / 1000, delta_ms);
+      res != HAL_OK)
   {
-    xprintf("Error: Wrong data format!\r");
+    xprintf("Error %u: Failed to calibrate!\r", res);
   }
 }
 
 /**
-  * @brief  Sends the current time and date to UART in format
-  *         dd/mm/yyyyy hh:mm:ss\r.
+  * @brief  Applies the correction by shifting the calendar if it is below
+  *         one second, so the time stays continuous.
+  * @param  delta_ms : true time minus the RTC time.
+  * @retval false if the calendar must be written instead.
   */
-void rtc_internal::print_time()
+bool rtc_internal::correct_time(const int64_t delta_ms)
 {
-  RTC_TimeTypeDef time_get;
-  if (const auto res = HAL_RTC_GetTime(&hrtc, &time_get, RTC_FORMAT_BIN); 
-      res != HAL_OK)
+  if ((delta_ms < -rtc_drift::max_shift_ms) || (delta_ms > rtc_drift::max_shift_ms))
   {
-    xprintf("Error %u: Failed to read time!\r", res);
+    return false;
   }
 
-  RTC_DateTypeDef date_get;
-  if (const auto res = HAL_RTC_GetDate(&hrtc, &date_get, RTC_FORMAT_BIN);
+  if (const auto res = rtc_drift::shift(static_cast<int32_t>(delta_ms));
       res != HAL_OK)
   {
-    xprintf("Error %u: Failed to read date!\r", res);
+    xprintf("Error %u: Failed to shift time!\r", res);
   }
 
-  xprintf("%02u/%02u/%4u %02u:%02u:%02u\r", 
-    date_get.Date, date_get.Month, 2000 + date_get.Year, 
-    time_get.Hours, time_get.Minutes, time_get.Seconds);
+  return true;
 }
 
-rtc_internal::rtc_res rtc_internal::fix_time(RTC_TimeTypeDef& time, const bool set_max)
+/**
+  * @brief  Calls write() within the RTC initialization mode, the same way as
+  *         the HAL setters do.
+  */
+template<typename Write>
+HAL_StatusTypeDef rtc_internal::write_in_init_mode(Write write)
 {
-  auto result = rtc_res::OK;
+  __HAL_LOCK(&hrtc);
+  hrtc.State = HAL_RTC_STATE_BUSY;
+  __HAL_RTC_WRITEPROTECTION_DISABLE(&hrtc);
 
-  if (const uint8_t max_hour = (hrtc.Init.HourFormat == RTC_HOURFORMAT_24) ? 23 : 12; 
-      time.Hours > max_hour)
+  auto status = RTC_EnterInitMode(&hrtc);
+
+  if (status == HAL_OK)
   {
-    time.Hours = set_max ? max_hour : 0;
-    result = rtc_res::WRONG_TIME;
+    write();
+    status = RTC_ExitInitMode(&hrtc);
   }
 
-  if (time.Minutes > 59)
+  if (status == HAL_OK)
   {
-    time.Minutes = set_max ? 59 : 0;
-    result = rtc_res::WRONG_TIME;
+    hrtc.State = HAL_RTC_STATE_READY;
   }
 
-  if (time.Seconds > 59)
+  __HAL_RTC_WRITEPROTECTION_ENABLE(&hrtc);
+  __HAL_UNLOCK(&hrtc);
+
+  return status;
+}
+
+/**
+  * @brief  Adds the alarm which sends "ALARM id" to UART, replies with its id.
+  * @param  day, month, year, hours, minutes, seconds : fields of
+  *         @ref rtc_cmd_parser::data_time_template
+  */
+void rtc_internal::add_alarm(const uint8_t day, const uint8_t month, const uint16_t year,
+                             const uint8_t hours, const uint8_t minutes, const uint8_t seconds)
+{
+  RTC_DateTypeDef date = {};
+  date.Date = day;
+  date.Month = month;
+  date.Year = static_cast<uint8_t>(year % 100);
+
+  RTC_TimeTypeDef time = {};
+  time.Hours = hours;
+  time.Minutes = minutes;
+  time.Seconds = seconds;
+
+  if ((fix_date(date, true) != rtc_res::OK) || (fix_time(time, true) != rtc_res::OK))
   {
-    time.Seconds = set_max ? 59 : 0;
-    result = rtc_res::WRONG_TIME;
+    xprintf("Error: Wrong alarm time!\r");
+    return;
   }
 
-  return result;
+  if (const uint16_t id = rtc_alarms::get_instance().add(rtc_calendar::to_epoch_s(date, time));
+      id != rtc_alarms::no_alarm)
+  {
+    xprintf("Alarm %u\r", id);
+  }
+  else
+  {
+    xprintf("Error: Too many alarms!\r");
+  }
 }
 
-rtc_internal::rtc_res rtc_internal::fix_date(RTC_DateTypeDef& date, const bool set_max)
+/**
+  * @brief  Writes TR and DR within one initialization mode window.
+  * @note   HAL_RTC_SetTime() and HAL_RTC_SetDate() enter the initialization
+  *         mode and wait for the shadow registers resynchronisation each,
+  *         and the calendar may tick between them (e.g. across midnight).
+  *         The time is written in 24-hour format or as AM in 12-hour format.
+  */
+HAL_StatusTypeDef rtc_internal::write_date_time(const RTC_DateTypeDef& date, const RTC_TimeTypeDef& time)
 {
-  auto result = rtc_res::OK;
+  const uint32_t tr = (static_cast<uint32_t>(RTC_ByteToBcd2(time.Hours)) << RTC_TR_HU_Pos) |
+                      (static_cast<uint32_t>(RTC_ByteToBcd2(time.Minutes)) << RTC_TR_MNU_Pos) |
+                      static_cast<uint32_t>(RTC_ByteToBcd2(time.Seconds));
+  const uint32_t dr = make_dr(date);
 
-  if (date.Month == 0)
+  return write_in_init_mode([tr, dr]()
   {
-    date.Month = 1;
-    result = rtc_res::WRONG_DATE;
+    hrtc.Instance->TR = tr & RTC_TR_RESERVED_MASK;
+    hrtc.Instance->DR = dr;
+  });
+}
+
+/**
+  * @retval The value of RTC_DR for the date and its week day.
+  */
+uint32_t rtc_internal::make_dr(const RTC_DateTypeDef& date)
+{
+  const uint32_t dr = (static_cast<uint32_t>(RTC_ByteToBcd2(date.Year)) << RTC_DR_YU_Pos) |
+                      (static_cast<uint32_t>(RTC_ByteToBcd2(date.Month)) << RTC_DR_MU_Pos) |
+                      static_cast<uint32_t>(RTC_ByteToBcd2(date.Date)) |
+                      (static_cast<uint32_t>(date.WeekDay) << RTC_DR_WDU_Pos);
+  return dr & RTC_DR_RESERVED_MASK;
+}
+
+/**
+  * @brief  Makes the time from the received fields. The wrong fields are
+  *         fixed and reported.
+  */
+RTC_TimeTypeDef rtc_internal::make_time(const uint8_t hours, const uint8_t minutes, const uint8_t seconds)
+{
+  RTC_TimeTypeDef time = {};
+  time.Hours = hours;
+  time.Minutes = minutes;
+  time.Seconds = seconds;
+
+  if (fix_time(time, true) != rtc_res::OK)
+  {
+    xprintf("Error: Wrong time! Maybe you mean: %02u:%02u:%02u?\r",
+      time.Hours,
+      time.Minutes,
+      time.Seconds);
   }
 
-  if (date.Month > 12)
+  return time;
+}
+
+/**
+  * @brief  Makes the date from the received fields. The wrong fields are
+  *         fixed and reported, the week day is computed.
+  */
+RTC_DateTypeDef rtc_internal::make_date(const uint8_t day, const uint8_t month, const uint16_t year)
+{
+  RTC_DateTypeDef date = {};
+  date.Date = day;
+  date.Month = month;
+  date.Year = static_cast<uint8_t>(year % 100);
+
+  if (fix_date(date, true) != rtc_res::OK)
   {
-    date.Month = set_max ? 12 : 1;
-    result = rtc_res::WRONG_DATE;
+    xprintf("Error: Wrong date! Maybe you mean: %02u/%02u/%4u?\r",
+      date.Date,
+      date.Month,
+      static_cast<unsigned int>(date.Year) + 2000);
   }
 
-  if (date.Date == 0)
+  date.WeekDay = rtc_calendar::weekday(date);
+  return date;
+}
+
+/**
+  * @brief  Sends the current time and date to UART in format
+  *         dd/mm/yyyyy hh:mm:ss\r.
+  * @note   The registers are read directly, see @ref rtc_snapshot. The second
+  *         is borrowed right after a shift, as by @ref print_time_ms().
+  */
+void rtc_internal::print_time()
+{
+  char text[rtc_snapshot::text_size];
+  xputs(now().normalized().format(text));
+  xputs("\r");
+}
+
+/**
+  * @brief  Sends the current time and date to UART in format
+  *         dd/mm/yyyyy hh:mm:ss.mmm\r.
+  */
+void rtc_internal::print_time_ms()
+{
+  char text[rtc_snapshot::text_ms_size];
+  xputs(now().format_ms(text));
+  xputs("\r");
+}
+
+/**
+  * @brief  Sends the current time and date with the week day to UART in format
+  *         dd/mm/yyyyy hh:mm:ss Www\r, e.g. "09/05/2024 17:40:00 Thu".
+  */
+void rtc_internal::print_time_weekday()
+{
+  const rtc_snapshot snapshot = now().normalized();
+  char text[rtc_snapshot::text_size];
+
+  xprintf("%s %s\r", snapshot.format(text), rtc_calendar::weekday_names[snapshot.date().WeekDay]);
+}
+
+/**
+  * @brief  Sends the milliseconds since 01/01/1970 to UART.
+  */
+void rtc_internal::print_epoch() const
+{
+  const int64_t ms = epoch_ms();
+  xprintf("%lu%03u\r", static_cast<unsigned long>(ms / 1000), static_cast<unsigned int>(ms % 1000));
+}
+
+/**
+  * @brief  Sends the error counters kept in the backup registers to UART.
+  */
+void rtc_internal::print_error_counters()
+{
+  using store = rtc_backup::store;
+
+  xprintf("Timeouts: %lu, queue full: %lu, dropped samples: %lu, lost timestamps: %lu\r",
+    static_cast<unsigned long>(store::get<rtc_backup::rx_time_outs>()),
+    static_cast<unsigned long>(store::get<rtc_backup::rx_queue_overflows>()),
+    static_cast<unsigned long>(store::get<rtc_backup::dropped_samples>()),
+    static_cast<unsigned long>(store::get<rtc_backup::lost_timestamps>()));
+}
+
+/**
+  * @retval The current time and date with sub-seconds, see @ref rtc_snapshot.
+  */
+rtc_snapshot rtc_internal::now()
+{
+  return rtc_snapshot::read(hrtc.Instance);
+}
+
+/**
+  * @retval Core cycles of the GET command path without UART: parsing of
+  *         "GET\r", reading the calendar and formatting the reply.
+  * @note   The DWT cycle counter must be running, see @ref boot_profile.
+  */
+uint32_t rtc_internal::measure_get_cycles()
+{
+  rtc_cmd_parser parser;
+  cmd_info cmd = {};
+  char text[rtc_snapshot::text_size];
+
+  const uint32_t start = DWT->CYCCNT;
+
+  for (const char c : { 'G', 'E', 'T', rtc_cmd_parser::end_char })
   {
-    date.Date = 1;
-    result = rtc_res::WRONG_DATE;
+    if (parser.feed(c, cmd) && (cmd.cmd == rtc_cmd::GET))
+    {
+      static_cast<void>(now().normalized().format(text));
+    }
   }
 
-  if (date.Date <= 28) 
+  return DWT->CYCCNT - start;
+}
+
+/**
+  * @brief  Sends to UART the cycles of the GET path with the caches off,
+  *         then with the cold and the warm caches.
+  * @note   The DMA buffers are in DTCM, they are not affected by the caches.
+  */
+void rtc_internal::print_cache_cycles()
+{
+  SCB_DisableICache();
+  SCB_DisableDCache();
+  const uint32_t off_cycles = measure_get_cycles();
+
+  // Enabling invalidates the caches, so the first run is with cold caches
+  SCB_EnableICache();
+  SCB_EnableDCache();
+  const uint32_t cold_cycles = measure_get_cycles();
+  const uint32_t warm_cycles = measure_get_cycles();
+
+  xprintf("GET path: %lu cycles caches off, %lu cold caches, %lu warm caches\r",
+    static_cast<unsigned long>(off_cycles),
+    static_cast<unsigned long>(cold_cycles),
+    static_cast<unsigned long>(warm_cycles));
+}
+
+/**
+  * @retval Milliseconds since 01/01/1970.
+  * @note   The seconds are taken from the cache while it matches the calendar,
+  *         they are computed from scratch only after the calendar has been
+  *         changed and until the next Alarm B.
+  */
+int64_t rtc_internal::epoch_ms() const
+{
+  const rtc_snapshot snapshot = now();
+
+  epoch_cache cache;
+  {
+    const irq_lock lock;
+    cache = f_epoch;
+  }
+
+  const int64_t epoch_s = ((snapshot.tr == cache.tr) && (snapshot.dr == cache.dr)) ?
+                          cache.epoch_s :
+                          rtc_calendar::to_epoch_s(snapshot.date(), snapshot.time());
+
+  return epoch_s * 1000 + snapshot.milliseconds(); // Borrows the second after a shift
+}
+
+/**
+  * @brief  Starts Alarm B on every second to keep @ref f_epoch up to date.
+  */
+void rtc_internal::start_epoch_clock()
+{
+  update_epoch_cache();
+
+  RTC_AlarmTypeDef alarm = {};
+  alarm.Alarm = RTC_ALARM_B;
+  alarm.AlarmMask = RTC_ALARMMASK_ALL;
+  alarm.AlarmSubSecondMask = RTC_ALARMSUBSECONDMASK_ALL;
+  alarm.AlarmDateWeekDaySel = RTC_ALARMDATEWEEKDAYSEL_DATE;
+  alarm.AlarmDateWeekDay = 1;
+
+  if (HAL_RTC_SetAlarm_IT(&hrtc, &alarm, RTC_FORMAT_BIN) != HAL_OK)
+  {
+    Error_Handler();
+  }
+}
+
+/**
+  * @brief  Updates the cached seconds since the epoch. The day number is
+  *         computed only when the date has changed.
+  */
+void rtc_internal::update_epoch_cache()
+{
+  const rtc_snapshot snapshot = now();
+
+  if (snapshot.dr != f_epoch.dr)
+  {
+    f_epoch.dr = snapshot.dr;
+    f_epoch.day_s = rtc_calendar::days_from_rtc(snapshot.date()) * rtc_calendar::seconds_per_day;
+  }
+
+  f_epoch.tr = snapshot.tr;
+  f_epoch.epoch_s = f_epoch.day_s + rtc_calendar::seconds_of_day(snapshot.time());
+}
+
+void HAL_RTCEx_AlarmBEventCallback(RTC_HandleTypeDef* hrtc)
+{
+  rtc_internal::get_instance().rtc_alarm_b_callback(hrtc);
+}
+
+/**
+  * @brief  Called by Alarm B on every second.
+  */
+void rtc_internal::rtc_alarm_b_callback(const RTC_HandleTypeDef* rtc_handle)
+{
+  if (rtc_handle == &hrtc)
+  {
+    update_epoch_cache();
+  }
+}
+
+/**
+  * @brief  Starts sending the current time in format dd/mm/yyyy hh:mm:ss.mmm
+  *         every period_ms. The timestamps are taken by the wakeup timer
+  *         interrupt and printed by the main loop.
+  */
+HAL_StatusTypeDef rtc_internal::subscribe(const uint16_t period_ms)
+{
+  const uint32_t counter = std::max<uint32_t>(period_ms * wakeup_clock_hz / 1000U, 1U) - 1U;
+  return HAL_RTCEx_SetWakeUpTimer_IT(&hrtc, counter, RTC_WAKEUPCLOCK_RTCCLK_DIV16);
+}
+
+HAL_StatusTypeDef rtc_internal::unsubscribe()
+{
+  return HAL_RTCEx_DeactivateWakeUpTimer(&hrtc);
+}
+
+/**
+  * @retval Number of timestamps lost because the main loop or UART
+  *         has not kept up with the subscription period.
+  */
+uint32_t rtc_internal::dropped_samples() const
+{
+  return f_dropped_samples;
+}
+
+void HAL_RTCEx_WakeUpTimerEventCallback(RTC_HandleTypeDef* hrtc)
+{
+  rtc_internal::get_instance().rtc_wakeup_callback(hrtc);
+}
+
+/**
+  * @brief  Called by the wakeup timer on every subscription period.
+  */
+void rtc_internal::rtc_wakeup_callback(const RTC_HandleTypeDef* rtc_handle)
+{
+  if ((rtc_handle == &hrtc) && !f_samples.push(now()))
+  {
+    f_dropped_samples = f_dropped_samples + 1;
+  }
+}
+
+/**
+  * @brief  Prints the queued timestamps while the UART TX ring has room,
+  *         so the main loop never waits for the UART. The timestamps
+  *         which don't fit in the queue meanwhile are dropped and counted.
+  */
+void rtc_internal::print_samples()
+{
+  if (const uint32_t dropped = f_dropped_samples; dropped != f_reported_dropped_samples)
+  {
+    xprintf("Error: %lu timestamps dropped!\r", static_cast<unsigned long>(dropped - f_reported_dropped_samples));
+    rtc_backup::store::add<rtc_backup::dropped_samples>(dropped - f_reported_dropped_samples);
+    f_reported_dropped_samples = dropped;
+  }
+
+  auto& stream = xuart_stream::get_instance();
+
+  while (const rtc_snapshot* sample = f_samples.front())
   {
-    return result;
+    if (stream.free_space() < rtc_snapshot::text_ms_size)
+    {
+      break;
+    }
+
+    char text[rtc_snapshot::text_ms_size];
+    xputs(sample->format_ms(text));
+    xputs("\r");
+    f_samples.pop();
   }
+}
 
-  uint8_t days_in_month = 31;
+/**
+  * @brief  Changes the prescalers without resetting the calendar.
+  * @note   The current second is restarted.
+  */
+HAL_StatusTypeDef rtc_internal::set_prescaler(const rtc_prescaler prescaler)
+{
+  const uint32_t async_prediv = (prescaler == rtc_prescaler::HIGH_RESOLUTION) ? 7 : 127;
+  const uint32_t sync_prediv = (prescaler == rtc_prescaler::HIGH_RESOLUTION) ? 4095 : 255;
 
-  if (date.Month == 2)
+  if (hrtc.Instance->PRER == ((async_prediv << RTC_PRER_PREDIV_A_Pos) | sync_prediv))
   {
-    const bool is_leap_year = (date.Year % 4) == 0;
-    days_in_month = is_leap_year ? 29 : 28;
+    return HAL_OK; // E.g. kept over the warm boot
   }
-  else if ((date.Month == 4) || (date.Month == 6) || (date.Month == 9) || (date.Month == 11))
+
+  const auto status = write_in_init_mode([async_prediv, sync_prediv]()
+  {
+    // Two separate writes are required: PREDIV_S first
+    hrtc.Instance->PRER = sync_prediv;
+    hrtc.Instance->PRER |= async_prediv << RTC_PRER_PREDIV_A_Pos;
+  });
+
+  if (status == HAL_OK)
   {
-    days_in_month = 30;
+    hrtc.Init.AsynchPrediv = async_prediv;
+    hrtc.Init.SynchPrediv = sync_prediv;
   }
 
-  if (date.Date > days_in_month) 
+  return status;
+}
+
+rtc_internal::rtc_res rtc_internal::fix_time(RTC_TimeTypeDef& time, const bool set_max)
+{
+  const uint8_t max_hour = (hrtc.Init.HourFormat == RTC_HOURFORMAT_24) ? 23 : 12;
+
+  if ((time.Hours <= max_hour) && (time.Minutes <= 59) && (time.Seconds <= 59))
   {
-    date.Date = set_max ? days_in_month : 1;
-    result = rtc_res::WRONG_DATE;
+    return rtc_res::OK;
   }
 
-  return result;
+  time.Hours = rtc_calendar::fix_field(time.Hours, 0, max_hour, set_max);
+  time.Minutes = rtc_calendar::fix_field(time.Minutes, 0, 59, set_max);
+  time.Seconds = rtc_calendar::fix_field(time.Seconds, 0, 59, set_max);
+
+  return rtc_res::WRONG_TIME;
 }
 
+/**
+  * @note   The clamping is done by @ref rtc_calendar::fix_date().
+  */
+rtc_internal::rtc_res rtc_internal::fix_date(RTC_DateTypeDef& date, const bool set_max)
+{
+  return rtc_calendar::fix_date(date, set_max) ? rtc_res::OK : rtc_res::WRONG_DATE;
+}
@@ -14,36 +14,68 @@
 #pragma once
 
 #include "main.h"
-#include "static_string.h"
+#include "spsc_queue.h"
+#include "rtc_cmd_parser.h"
+#include "rtc_snapshot.h"
+#include "rx_dma_reader.h"
 
 class rtc_internal
 {
 public:
-  enum class rtc_cmd
-  {
-    SET_T,
-    SET_D,
-    GET,
-    NONE
-  };
+  using rtc_cmd = rtc_cmd_parser::rtc_cmd;
+  using cmd_err = rtc_cmd_parser::cmd_err;
+  using cmd_info = rtc_cmd_parser::cmd_info;
 
-  struct cmd_info
+  // Prescalers of the 32.768 kHz LSE clock
+  enum class rtc_prescaler
   {
-    rtc_cmd cmd;
-    const char* res_str;
+    DEFAULT,        // Async 128, sync 256: 1/256 s resolution, as set by MX_RTC_Init()
+    HIGH_RESOLUTION // Async 8, sync 4096: 1/4096 s resolution, higher consumption
   };
 
   [[nodiscard]] static rtc_internal& get_instance();
-  void init(UART_HandleTypeDef& huart);
+  void init(UART_HandleTypeDef& huart, rtc_prescaler prescaler = rtc_prescaler::DEFAULT);
+  void start_epoch_clock();
   void check_time_out_reception();
   void uart_rx_cplt_callback(const UART_HandleTypeDef* huart);
-  [[nodiscard]] cmd_info parse_received_msg();
-  static void execute_cmd(const cmd_info& data);
-  static void set_time(const char* str);
-  static void set_date(const char* str);
+  void uart_idle_callback(const UART_HandleTypeDef* huart);
+  void uart_error_callback(const UART_HandleTypeDef* huart);
+  void rtc_alarm_b_callback(const RTC_HandleTypeDef* rtc_handle);
+  void rtc_wakeup_callback(const RTC_HandleTypeDef* rtc_handle);
+  void process_received_msgs();
+  [[nodiscard]] size_t queue_depth() const;
+  [[nodiscard]] size_t queue_high_water() const;
+  void execute_cmd(const cmd_info& data);
+  static void set_time(uint8_t hours, uint8_t minutes, uint8_t seconds);
+  static void set_date(uint8_t day, uint8_t month, uint16_t year);
+  static void set_date_time(uint8_t day, uint8_t month, uint16_t year,
+                            uint8_t hours, uint8_t minutes, uint8_t seconds);
+  static void add_alarm(uint8_t day, uint8_t month, uint16_t year,
+                        uint8_t hours, uint8_t minutes, uint8_t seconds);
   static void print_time();
+  static void print_time_ms();
+  static void print_time_weekday();
+  void print_epoch() const;
+  static void print_error_counters();
+  [[nodiscard]] static rtc_snapshot now();
+  [[nodiscard]] static uint32_t measure_get_cycles();
+  static void print_cache_cycles();
+  [[nodiscard]] int64_t epoch_ms() const;
+  [[nodiscard]] HAL_StatusTypeDef subscribe(uint16_t period_ms);
+  [[nodiscard]] HAL_StatusTypeDef unsubscribe();
+  [[nodiscard]] uint32_t dropped_samples() const;
+  [[nodiscard]] static HAL_StatusTypeDef set_prescaler(rtc_prescaler prescaler);
 
 private:
+  static constexpr size_t rx_dma_buf_size = 64; // Circular buffer of the USART RX DMA
+  static constexpr size_t rx_queue_size = 16;   // Max number of commands waiting for the main loop
+  static constexpr size_t max_frame_cmds = 16;  // Commands per msg received within the time-out
+  static constexpr uint16_t min_period_ms = 10;    // Subscription rate limit
+  static constexpr uint16_t max_period_ms = 32000; // 16-bit wakeup timer clocked by RTCCLK / 16
+  static constexpr uint32_t wakeup_clock_hz = 32768 / 16;
+  static constexpr size_t sample_queue_size = 16; // Timestamps waiting for the main loop
+  static constexpr size_t parse_probe_slot = static_cast<size_t>(rtc_cmd::NONE); // cycle_profile slots: commands, then the parser
+
   enum class rtc_res
   {
     OK,
@@ -51,26 +83,54 @@ private:
     WRONG_DATE
   };
 
+  // Seconds since the epoch for the TR/DR values, updated every second by Alarm B
+  struct epoch_cache
+  {
+    uint32_t tr;
+    uint32_t dr;
+    int64_t day_s;   // Seconds since the epoch at the beginning of the day
+    int64_t epoch_s;
+  };
+
+  struct rx_error
+  {
+    volatile uint32_t occurred; // Incremented by the interrupt
+    uint32_t reported;          // Incremented by the main loop
+  };
+
   explicit rtc_internal();
   void initiate_reception();
   void start_receive_msg();
-  void restart_msg_reception();
-  void forming_rx_msg();
+  void process_rx_dma();
+  void forming_rx_msg(uint8_t c);
+  void update_epoch_cache();
+  void print_samples();
+  static uint32_t report_rx_error(rx_error& err, const char* msg);
+  static void report_wrong_format(rtc_cmd cmd);
+  static void add_drift_correction(int64_t rtc_ms, int64_t delta_ms);
+  [[nodiscard]] static bool correct_time(int64_t delta_ms);
+  template<typename Write>
+  [[nodiscard]] static HAL_StatusTypeDef write_in_init_mode(Write write);
+  [[nodiscard]] static HAL_StatusTypeDef write_date_time(const RTC_DateTypeDef& date, const RTC_TimeTypeDef& time);
+  [[nodiscard]] static uint32_t make_dr(const RTC_DateTypeDef& date);
+  [[nodiscard]] static RTC_TimeTypeDef make_time(uint8_t hours, uint8_t minutes, uint8_t seconds);
+  [[nodiscard]] static RTC_DateTypeDef make_date(uint8_t day, uint8_t month, uint16_t year);
   static rtc_res fix_time(RTC_TimeTypeDef& time, bool set_max);
   static rtc_res fix_date(RTC_DateTypeDef& date, bool set_max);
 
 private:
-  static constexpr auto cmd_set_t = snw1::STOSS("SET_T ");
-  static constexpr auto cmd_set_d = snw1::STOSS("SET_D ");
-  static constexpr auto cmd_get = snw1::STOSS("GET");
-  static constexpr auto time_template = snw1::STOSS("hh:mm:ss");
-  static constexpr auto data_template = snw1::STOSS("dd/mm/yyyy");
-  static constexpr size_t rx_buf_size = snw1::max<cmd_set_t.length() + time_template.length(),
-                                                  cmd_set_d.length() + data_template.length(),
-                                                  cmd_get.length()>() + 1;
   UART_HandleTypeDef* f_huart = nullptr;
   uint32_t f_max_reception_time_ms = 0;
-  volatile uint8_t f_rx_buf[rx_buf_size] = { '\0' };
-  volatile size_t f_rx_buf_index = 0;
-  volatile char f_rx_msg[rx_buf_size] = { '\0' };
+  static volatile uint8_t f_rx_dma_buf[rx_dma_buf_size]; // In DTCM: uncached, accessible by DMA
+  rx_dma_reader<rx_dma_buf_size> f_rx_dma;
+  rtc_cmd_parser f_parser;
+  volatile bool f_rx_time_out = false; // Set by SysTick, the parser is reset on the next byte
+  spsc_queue<cmd_info, rx_queue_size> f_rx_queue;
+  bool f_tx_batch = false; // The replies are held until the end of the msg
+  epoch_cache f_epoch = { 0, 0, 0, 0 };
+  spsc_queue<rtc_snapshot, sample_queue_size> f_samples;
+  volatile uint32_t f_dropped_samples = 0;
+  uint32_t f_reported_dropped_samples = 0;
+  rx_error f_err_time_out = { 0, 0 };
+  rx_error f_err_queue_full = { 0, 0 };
 };
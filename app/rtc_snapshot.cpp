@@ -0,0 +1,178 @@
+/**
+  ******************************************************************************
+  * @file           : rtc_snapshot.cpp
+  * @author         : Rusanov M.N.
+  ******************************************************************************
+  */
+
+#include "rtc_snapshot.h"
+#include "rtc_calendar.h"
+
+namespace
+{
+  constexpr uint8_t bcd_field(const uint32_t reg, const uint32_t pos, const uint32_t tens_mask)
+  {
+    return static_cast<uint8_t>(((reg >> (pos + 4)) & tens_mask) * 10 + ((reg >> pos) & 0x0F));
+  }
+
+  constexpr uint32_t bcd(const uint8_t value, const uint32_t pos)
+  {
+    return static_cast<uint32_t>(((value / 10) << 4) | (value % 10)) << pos;
+  }
+
+  /**
+    * @brief  Writes the 2 BCD digits of the register field as text.
+    */
+  char* put_bcd(char* str, const uint32_t reg, const uint32_t pos, const uint32_t tens_mask)
+  {
+    *str++ = static_cast<char>('0' + ((reg >> (pos + 4)) & tens_mask));
+    *str++ = static_cast<char>('0' + ((reg >> pos) & 0x0F));
+    return str;
+  }
+
+  char* put_date_time(char* str, const uint32_t dr, const uint32_t tr)
+  {
+    str = put_bcd(str, dr, RTC_DR_DU_Pos, RTC_DR_DT_Msk >> RTC_DR_DT_Pos);
+    *str++ = '/';
+    str = put_bcd(str, dr, RTC_DR_MU_Pos, RTC_DR_MT_Msk >> RTC_DR_MT_Pos);
+    *str++ = '/';
+    *str++ = '2';
+    *str++ = '0';
+    str = put_bcd(str, dr, RTC_DR_YU_Pos, RTC_DR_YT_Msk >> RTC_DR_YT_Pos);
+    *str++ = ' ';
+    str = put_bcd(str, tr, RTC_TR_HU_Pos, RTC_TR_HT_Msk >> RTC_TR_HT_Pos);
+    *str++ = ':';
+    str = put_bcd(str, tr, RTC_TR_MNU_Pos, RTC_TR_MNT_Msk >> RTC_TR_MNT_Pos);
+    *str++ = ':';
+    return put_bcd(str, tr, RTC_TR_SU_Pos, RTC_TR_ST_Msk >> RTC_TR_ST_Pos);
+  }
+}
+
+/**
+  * @brief  Takes a coherent snapshot of the calendar in a few register reads.
+  * @note   With the shadow registers (BYPSHAD = 0) reading SSR locks TR and DR
+  *         until DR is read. With BYPSHAD = 1 the registers are read from the
+  *         counters, so the snapshot is taken again if SSR has changed
+  *         meanwhile: TR and DR may only change together with SSR.
+  */
+rtc_snapshot rtc_snapshot::read(const RTC_TypeDef* rtc)
+{
+  rtc_snapshot result;
+  result.second_fraction = rtc->PRER & RTC_PRER_PREDIV_S;
+
+  if ((rtc->CR & RTC_CR_BYPSHAD) == 0U)
+  {
+    result.ssr = rtc->SSR;
+    result.tr = rtc->TR;
+    result.dr = rtc->DR;
+    return result;
+  }
+
+  do
+  {
+    result.ssr = rtc->SSR;
+    result.tr = rtc->TR;
+    result.dr = rtc->DR;
+  } while (result.ssr != rtc->SSR);
+
+  return result;
+}
+
+/**
+  * @retval Milliseconds elapsed since the beginning of the second, negative
+  *         right after a shift operation, see @ref rtc_calendar::milliseconds().
+  */
+int16_t rtc_snapshot::milliseconds() const
+{
+  return static_cast<int16_t>(rtc_calendar::milliseconds(ssr, second_fraction));
+}
+
+/**
+  * @retval The same time with SSR within 0...PREDIV_S: right after a shift
+  *         operation SSR > PREDIV_S and the second is borrowed from TR/DR.
+  */
+rtc_snapshot rtc_snapshot::normalized() const
+{
+  if (ssr <= second_fraction)
+  {
+    return *this;
+  }
+
+  // Whole seconds are borrowed, so the fraction is kept exactly
+  const uint32_t borrowed_s = ssr / (second_fraction + 1U);
+  RTC_DateTypeDef date_value = date();
+  RTC_TimeTypeDef time_value = time();
+  rtc_calendar::from_epoch_ms((rtc_calendar::to_epoch_s(date_value, time_value) - borrowed_s) * 1000,
+                              date_value, time_value);
+
+  rtc_snapshot result = *this;
+  result.ssr = ssr - borrowed_s * (second_fraction + 1U);
+  result.tr = (tr & RTC_TR_PM) |
+              bcd(time_value.Hours, RTC_TR_HU_Pos) |
+              bcd(time_value.Minutes, RTC_TR_MNU_Pos) |
+              bcd(time_value.Seconds, RTC_TR_SU_Pos);
+  result.dr = bcd(date_value.Year, RTC_DR_YU_Pos) |
+              (static_cast<uint32_t>(date_value.WeekDay) << RTC_DR_WDU_Pos) |
+              bcd(date_value.Month, RTC_DR_MU_Pos) |
+              bcd(date_value.Date, RTC_DR_DU_Pos);
+  return result;
+}
+
+/**
+  * @retval The date in binary format, as HAL_RTC_GetDate() returns it.
+  */
+RTC_DateTypeDef rtc_snapshot::date() const
+{
+  RTC_DateTypeDef result;
+  result.Year = bcd_field(dr, RTC_DR_YU_Pos, RTC_DR_YT_Msk >> RTC_DR_YT_Pos);
+  result.Month = bcd_field(dr, RTC_DR_MU_Pos, RTC_DR_MT_Msk >> RTC_DR_MT_Pos);
+  result.Date = bcd_field(dr, RTC_DR_DU_Pos, RTC_DR_DT_Msk >> RTC_DR_DT_Pos);
+  result.WeekDay = static_cast<uint8_t>((dr & RTC_DR_WDU) >> RTC_DR_WDU_Pos);
+  return result;
+}
+
+/**
+  * @retval The time in binary format, as HAL_RTC_GetTime() returns it.
+  */
+RTC_TimeTypeDef rtc_snapshot::time() const
+{
+  RTC_TimeTypeDef result = {};
+  result.Hours = bcd_field(tr, RTC_TR_HU_Pos, RTC_TR_HT_Msk >> RTC_TR_HT_Pos);
+  result.Minutes = bcd_field(tr, RTC_TR_MNU_Pos, RTC_TR_MNT_Msk >> RTC_TR_MNT_Pos);
+  result.Seconds = bcd_field(tr, RTC_TR_SU_Pos, RTC_TR_ST_Msk >> RTC_TR_ST_Pos);
+  result.TimeFormat = static_cast<uint8_t>((tr & RTC_TR_PM) >> RTC_TR_PM_Pos);
+  result.SubSeconds = ssr;
+  result.SecondFraction = second_fraction;
+  return result;
+}
+
+/**
+  * @brief  Writes the snapshot as text of format dd/mm/yyyy hh:mm:ss.
+  * @retval Pointer to the text.
+  */
+char* rtc_snapshot::format(char (&text)[text_size]) const
+{
+  *put_date_time(text, dr, tr) = '\0';
+  return text;
+}
+
+/**
+  * @brief  Writes the snapshot as text of format dd/mm/yyyy hh:mm:ss.mmm.
+  * @note   The second is borrowed right after a shift operation,
+  *         see @ref normalized().
+  * @retval Pointer to the text.
+  */
+char* rtc_snapshot::format_ms(char (&text)[text_ms_size]) const
+{
+  const rtc_snapshot snapshot = normalized();
+  char* str = put_date_time(text, snapshot.dr, snapshot.tr);
+  const auto ms = static_cast<uint16_t>(snapshot.milliseconds());
+
+  *str++ = '.';
+  *str++ = static_cast<char>('0' + ms / 100);
+  *str++ = static_cast<char>('0' + ms / 10 % 10);
+  *str++ = static_cast<char>('0' + ms % 10);
+  *str = '\0';
+
+  return text;
+}
@@ -0,0 +1,38 @@
+/**
+  ******************************************************************************
+  * @file           : rtc_snapshot.h
+  * @author         : Rusanov M.N.
+  * @version        : V1.0.0
+  * @date           : 16-Oct-2026
+  * @brief          : Header for rtc_snapshot.cpp file.
+  *                   Fast reading of the RTC calendar: the SSR/TR/DR registers
+  *                   are read as they are, in BCD, without the HAL and its
+  *                   conversions. The text is made straight from the BCD digits.
+  *                   The sub-seconds are SSR counting down from PREDIV_S, the
+  *                   same as SubSeconds and SecondFraction of RTC_TimeTypeDef.
+  *
+  ******************************************************************************
+  */
+
+#pragma once
+
+#include "main.h"
+
+struct rtc_snapshot
+{
+  static constexpr size_t text_size = sizeof("dd/mm/yyyy hh:mm:ss");        // With '\0'
+  static constexpr size_t text_ms_size = sizeof("dd/mm/yyyy hh:mm:ss.mmm"); // With '\0'
+
+  uint32_t ssr;             // RTC_SSR: sub-seconds, counting down
+  uint32_t tr;              // RTC_TR: hh:mm:ss in BCD
+  uint32_t dr;              // RTC_DR: yy/mm/dd and week day in BCD
+  uint32_t second_fraction; // PREDIV_S: SSR at the beginning of the second
+
+  [[nodiscard]] static rtc_snapshot read(const RTC_TypeDef* rtc);
+  [[nodiscard]] int16_t milliseconds() const;
+  [[nodiscard]] rtc_snapshot normalized() const;
+  [[nodiscard]] RTC_DateTypeDef date() const;
+  [[nodiscard]] RTC_TimeTypeDef time() const;
+  char* format(char (&text)[text_size]) const;
+  char* format_ms(char (&text)[text_ms_size]) const;
+};
@@ -0,0 +1,122 @@
+/**
+  ******************************************************************************
+  * @file           : rtc_timestamps.cpp
+  * @author         : Rusanov M.N.
+  ******************************************************************************
+  */
+
+#include "rtc_timestamps.h"
+#include "xprintf.h"
+#include "rtc_backup.h"
+
+extern RTC_HandleTypeDef hrtc;
+
+rtc_timestamps::rtc_timestamps() = default;
+
+rtc_timestamps& rtc_timestamps::get_instance()
+{
+  static rtc_timestamps instance;
+  return instance;
+}
+
+/**
+  * @brief  Starts latching the calendar on the edges of the RTC_TS pin.
+  * @param  edge : RTC_TIMESTAMPEDGE_RISING or RTC_TIMESTAMPEDGE_FALLING.
+  */
+HAL_StatusTypeDef rtc_timestamps::start(const uint32_t edge)
+{
+  return HAL_RTCEx_SetTimeStamp_IT(&hrtc, edge, RTC_TIMESTAMPPIN_DEFAULT);
+}
+
+HAL_StatusTypeDef rtc_timestamps::stop()
+{
+  return HAL_RTCEx_DeactivateTimeStamp(&hrtc);
+}
+
+/**
+  * @retval Number of edges lost because the queue was full or the next edge
+  *         came before the previous one had been handled.
+  */
+uint32_t rtc_timestamps::lost_events() const
+{
+  return f_lost_events;
+}
+
+/**
+  * @brief  Sends all queued timestamps to UART in one transmission:
+  *         "Timestamps: n\r" and n lines in format dd/mm/yyyy hh:mm:ss.mmm\r,
+  *         the oldest first.
+  * @note   The edges latched meanwhile are left for the next dump.
+  */
+void rtc_timestamps::dump()
+{
+  if (const uint32_t lost = f_lost_events; lost != f_reported_lost_events)
+  {
+    xprintf("Error: %lu timestamps lost!\r", static_cast<unsigned long>(lost - f_reported_lost_events));
+    rtc_backup::store::add<rtc_backup::lost_timestamps>(lost - f_reported_lost_events);
+    f_reported_lost_events = lost;
+  }
+
+  size_t count = f_events.size();
+  xprintf("Timestamps: %u\r", static_cast<unsigned int>(count));
+
+  for (; count > 0; --count)
+  {
+    char text[rtc_snapshot::text_ms_size];
+    xputs(f_events.front()->format_ms(text));
+    xputs("\r");
+    f_events.pop();
+  }
+}
+
+void HAL_RTCEx_TimeStampEventCallback(RTC_HandleTypeDef* hrtc)
+{
+  rtc_timestamps::get_instance().rtc_timestamp_callback(hrtc);
+}
+
+/**
+  * @brief  Called by the timestamp interrupt before the HAL clears TSF,
+  *         which also clears the latched registers.
+  */
+void rtc_timestamps::rtc_timestamp_callback(const RTC_HandleTypeDef* rtc_handle)
+{
+  if (rtc_handle != &hrtc)
+  {
+    return;
+  }
+
+  if (__HAL_RTC_TIMESTAMP_GET_FLAG(&hrtc, RTC_FLAG_TSOVF) != 0U)
+  {
+    __HAL_RTC_TIMESTAMP_CLEAR_FLAG(&hrtc, RTC_FLAG_TSOVF);
+    f_lost_events = f_lost_events + 1;
+  }
+
+  if (!f_events.push(latched(hrtc.Instance)))
+  {
+    f_lost_events = f_lost_events + 1;
+  }
+}
+
+/**
+  * @brief  Makes the snapshot from the TSSSR/TSTR/TSDR registers.
+  * @note   The year is the current one, or the previous one if the edge was
+  *         latched in December and is handled in January.
+  */
+rtc_snapshot rtc_timestamps::latched(const RTC_TypeDef* rtc)
+{
+  const rtc_snapshot now = rtc_snapshot::read(rtc);
+  const uint32_t tsdr = rtc->TSDR;
+  uint32_t year = now.dr & (RTC_DR_YT | RTC_DR_YU);
+
+  if ((tsdr & (RTC_TSDR_MT | RTC_TSDR_MU)) > (now.dr & (RTC_DR_MT | RTC_DR_MU)))
+  {
+    const auto previous = static_cast<uint8_t>((RTC_Bcd2ToByte(static_cast<uint8_t>(year >> RTC_DR_YU_Pos)) + 99) % 100);
+    year = static_cast<uint32_t>(RTC_ByteToBcd2(previous)) << RTC_DR_YU_Pos;
+  }
+
+  rtc_snapshot result = now;
+  result.ssr = rtc->TSSSR;
+  result.tr = rtc->TSTR;
+  result.dr = year | tsdr;
+  return result;
+}
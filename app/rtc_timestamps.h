@@ -0,0 +1,45 @@
+/**
+  ******************************************************************************
+  * @file           : rtc_timestamps.h
+  * @author         : Rusanov M.N.
+  * @version        : V1.0.0
+  * @date           : 16-Oct-2026
+  * @brief          : Header for rtc_timestamps.cpp file.
+  *                   Hardware timestamps of the edges on the RTC_TS pin (PC13).
+  *                   The RTC latches the calendar and the sub-seconds on the
+  *                   edge itself, the interrupt only moves the latched values
+  *                   into a lock-free queue, which is drained in bulk by
+  *                   the main loop.
+  * @note           : The latched date has no year, the year is taken from
+  *                   the calendar when the interrupt is handled.
+  *
+  ******************************************************************************
+  */
+
+#pragma once
+
+#include "main.h"
+#include "spsc_queue.h"
+#include "rtc_snapshot.h"
+
+class rtc_timestamps
+{
+public:
+  static constexpr size_t max_events = 64; // Must be a power of 2
+
+  [[nodiscard]] static rtc_timestamps& get_instance();
+  [[nodiscard]] HAL_StatusTypeDef start(uint32_t edge = RTC_TIMESTAMPEDGE_RISING);
+  [[nodiscard]] HAL_StatusTypeDef stop();
+  void dump();
+  [[nodiscard]] uint32_t lost_events() const;
+  void rtc_timestamp_callback(const RTC_HandleTypeDef* rtc_handle);
+
+private:
+  explicit rtc_timestamps();
+  [[nodiscard]] static rtc_snapshot latched(const RTC_TypeDef* rtc);
+
+private:
+  spsc_queue<rtc_snapshot, max_events> f_events;
+  volatile uint32_t f_lost_events = 0; // Queue full or the RTC overflow flag
+  uint32_t f_reported_lost_events = 0;
+};
@@ -0,0 +1,64 @@
+/**
+  ******************************************************************************
+  * @file           : rx_dma_reader.h
+  * @author         : Rusanov M.N.
+  * @version        : V1.0.0
+  * @date           : 17-Oct-2026
+  * @brief          : Read position of a circular DMA reception. The DMA
+  *                   write position is found from the NDTR counter, so the
+  *                   bytes written since the last read are passed on in
+  *                   order whichever event has triggered the read: half
+  *                   transfer, transfer complete (buffer wrap) or idle line.
+  * @note           : The DMA must not write a whole buffer between two reads,
+  *                   the half and complete transfer events guarantee it.
+  *                   The reader doesn't depend on the HAL, it is tested on
+  *                   the host by test/rx_dma_reader_test.cpp.
+  *
+  ******************************************************************************
+  */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+template<size_t Size>
+class rx_dma_reader
+{
+  static_assert(Size >= 2, "Wrong size of the DMA buffer");
+
+public:
+  /**
+    * @brief  Must be called when the DMA is (re)started at the beginning
+    *         of the buffer.
+    */
+  void reset()
+  {
+    f_pos = 0;
+  }
+
+  /**
+    * @brief  Passes all bytes written by DMA since the last call to consume().
+    * @param  counter : NDTR, the number of transfers left till the buffer wraps,
+    *         Size right after the wrap.
+    */
+  template<typename Consume>
+  void read(const volatile uint8_t (&buf)[Size], const size_t counter, Consume consume)
+  {
+    const size_t dma_pos = (Size - counter) % Size;
+
+    while (f_pos != dma_pos)
+    {
+      consume(buf[f_pos]);
+      f_pos = (f_pos + 1) % Size;
+    }
+  }
+
+  [[nodiscard]] size_t position() const
+  {
+    return f_pos;
+  }
+
+private:
+  size_t f_pos = 0;
+};
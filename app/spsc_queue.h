@@ -0,0 +1,118 @@
+/**
+  ******************************************************************************
+  * @file           : spsc_queue.h
+  * @author         : Rusanov M.N.
+  * @version        : V1.0.0
+  * @date           : 16-Oct-2026
+  * @brief          : Wait-free single-producer/single-consumer queue with
+  *                   a fixed capacity. It is used to pass data from an
+  *                   interrupt handler (producer) to the main loop (consumer).
+  * @note           : Only one context may call the producer functions
+  *                   (back(), push()) and only one context may call the
+  *                   consumer functions (front(), pop()).
+  *
+  ******************************************************************************
+  */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+template<typename T, size_t Size>
+class spsc_queue
+{
+  static_assert(Size >= 2 && (Size & (Size - 1)) == 0, "Size must be a power of 2");
+
+public:
+  /**
+    * @brief  Producer: returns the free slot to be filled in place or nullptr
+    *         if the queue is full. The slot is published by @ref push().
+    */
+  [[nodiscard]] T* back()
+  {
+    const size_t head = f_head.load(std::memory_order_relaxed);
+    if (head - f_tail.load(std::memory_order_acquire) >= Size)
+    {
+      return nullptr;
+    }
+
+    return &f_items[head & (Size - 1)];
+  }
+
+  /**
+    * @brief  Producer: publishes the slot returned by @ref back().
+    */
+  void push()
+  {
+    const size_t head = f_head.load(std::memory_order_relaxed) + 1;
+    f_head.store(head, std::memory_order_release);
+
+    const size_t depth = head - f_tail.load(std::memory_order_relaxed);
+    if (depth > f_high_water.load(std::memory_order_relaxed))
+    {
+      f_high_water.store(depth, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+    * @brief  Producer: copies the item into the queue.
+    * @retval false if the queue is full.
+    */
+  [[nodiscard]] bool push(const T& item)
+  {
+    T* slot = back();
+    if (slot == nullptr)
+    {
+      return false;
+    }
+
+    *slot = item;
+    push();
+    return true;
+  }
+
+  /**
+    * @brief  Consumer: returns the oldest item or nullptr if the queue is empty.
+    *         The item stays valid until @ref pop() is called.
+    */
+  [[nodiscard]] const T* front() const
+  {
+    const size_t tail = f_tail.load(std::memory_order_relaxed);
+    if (tail == f_head.load(std::memory_order_acquire))
+    {
+      return nullptr;
+    }
+
+    return &f_items[tail & (Size - 1)];
+  }
+
+  /**
+    * @brief  Consumer: releases the item returned by @ref front().
+    */
+  void pop()
+  {
+    f_tail.store(f_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  [[nodiscard]] size_t size() const
+  {
+    return f_head.load(std::memory_order_acquire) - f_tail.load(std::memory_order_acquire);
+  }
+
+  [[nodiscard]] size_t high_water() const
+  {
+    return f_high_water.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] static constexpr size_t capacity()
+  {
+    return Size;
+  }
+
+private:
+  T f_items[Size] = {};
+  std::atomic<size_t> f_head = 0; // Written by the producer only
+  std::atomic<size_t> f_tail = 0; // Written by the consumer only
+  std::atomic<size_t> f_high_water = 0;
+};
@@ -0,0 +1,87 @@
+/**
+  ******************************************************************************
+  * @file           : stack_monitor.cpp
+  * @author         : Rusanov M.N.
+  ******************************************************************************
+  */
+
+#include "stack_monitor.h"
+#include "xprintf.h"
+
+// Defined in the linker script, the addresses are the values
+extern "C" uint32_t _estack;
+extern "C" uint32_t _sstack_paint;
+extern "C" uint32_t _Min_Stack_Size;
+
+stack_monitor::stack_monitor() = default;
+
+stack_monitor& stack_monitor::get_instance()
+{
+  static stack_monitor instance;
+  return instance;
+}
+
+/**
+  * @retval Bytes reserved for the stack by the linker script.
+  */
+uint32_t stack_monitor::reserved()
+{
+  return reinterpret_cast<uint32_t>(&_Min_Stack_Size);
+}
+
+/**
+  * @retval Bytes painted by the startup, the max measurable high-water mark.
+  */
+uint32_t stack_monitor::painted()
+{
+  return reinterpret_cast<uint32_t>(&_estack) - reinterpret_cast<uint32_t>(&_sstack_paint);
+}
+
+/**
+  * @retval Bytes of the stack used now.
+  */
+uint32_t stack_monitor::used()
+{
+  return reinterpret_cast<uint32_t>(&_estack) - __get_MSP();
+}
+
+/**
+  * @retval Max bytes of the stack used since the reset, equals @ref painted()
+  *         if the stack has gone deeper than the painted area.
+  */
+uint32_t stack_monitor::high_water()
+{
+  const uint32_t* word = &_sstack_paint;
+  const uint32_t* const end = &_estack;
+
+  while ((word != end) && (*word == paint_pattern))
+  {
+    ++word;
+  }
+
+  return reinterpret_cast<uint32_t>(end) - reinterpret_cast<uint32_t>(word);
+}
+
+/**
+  * @brief  Sends the stack use to UART in format
+  *         "Stack: n used, n max, n reserved, n painted\r".
+  */
+void stack_monitor::report() const
+{
+  const uint32_t max = high_water();
+
+  xprintf("Stack: %lu used, %lu max, %lu reserved, %lu painted\r",
+    static_cast<unsigned long>(used()),
+    static_cast<unsigned long>(max),
+    static_cast<unsigned long>(reserved()),
+    static_cast<unsigned long>(painted()));
+
+  if (max >= painted())
+  {
+    xprintf("Error: Stack has gone deeper than the painted area!\r");
+  }
+  else if (max > reserved())
+  {
+    xprintf("Error: Stack exceeds the reservation!\r");
+  }
+}
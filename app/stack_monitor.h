@@ -0,0 +1,38 @@
+/**
+  ******************************************************************************
+  * @file           : stack_monitor.h
+  * @author         : Rusanov M.N.
+  * @version        : V1.0.0
+  * @date           : 16-Oct-2026
+  * @brief          : Header for stack_monitor.cpp file.
+  *                   Measures the high-water mark of the main stack (MSP).
+  *                   The startup paints the stack with @ref paint_pattern
+  *                   down to _sstack_paint (4 reservations of
+  *                   _Min_Stack_Size), the deepest overwritten word is the
+  *                   high-water mark.
+  * @note           : The interrupts run on the MSP too, so the mark
+  *                   includes the nested interrupts and their exception
+  *                   frames. tools/stack_usage.py gives the static worst case.
+  *
+  ******************************************************************************
+  */
+
+#pragma once
+
+#include "main.h"
+
+class stack_monitor
+{
+public:
+  static constexpr uint32_t paint_pattern = 0xA5A5A5A5; // Must match the startup
+
+  [[nodiscard]] static stack_monitor& get_instance();
+  [[nodiscard]] static uint32_t reserved();
+  [[nodiscard]] static uint32_t painted();
+  [[nodiscard]] static uint32_t used();
+  [[nodiscard]] static uint32_t high_water();
+  void report() const;
+
+private:
+  explicit stack_monitor();
+};
@@ -13,6 +13,7 @@ Added:
     to_c_string()
     c_str()
     max()
+    NO_HEAP (no to_string() and str(), which allocate)
 
 Licensed under the MIT License <http://opensource.org/licenses/MIT>.
 SPDX-License-Identifier: MIT
@@ -40,8 +41,14 @@ SOFTWARE.
 #ifndef SNW1_STATIC_STRING_H
 #define SNW1_STATIC_STRING_H
 
-#include <string>
+#include <cstddef>
+#include <iosfwd>
 #include <limits>
+#include <type_traits>
+#include <utility>
+#if !NO_HEAP
+#include <string> // to_string() and str() allocate, not available in the NO_HEAP build
+#endif
 
 #define USE_USER_LITERALS 0
 
@@ -242,10 +249,12 @@ constexpr unsigned long long to_uint(const basic_static_string<Char, Size>& str,
         (str.data[index] - static_cast<Char>('0')) + 10ULL * to_uint(str, index - 1);
 }
 
+#if !NO_HEAP
 template<typename Char, size_t Size>
 std::basic_string<Char> to_string(const basic_static_string<Char, Size>& str) {
     return std::basic_string<Char>(str.data);
 }
+#endif
 
 template<typename Char, size_t Size>
 const Char* to_c_string(const basic_static_string<Char, Size>& str) {
@@ -427,9 +436,11 @@ struct basic_static_string {
         return __static_string_detail::to_uint(*this, 0);
     }
 
+#if !NO_HEAP
     [[nodiscard]] std::string str() const {
         return __static_string_detail::to_string(*this);
     }
+#endif
 
     [[nodiscard]] const Char* c_str() const {
         return __static_string_detail::to_c_string(*this);
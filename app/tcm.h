@@ -0,0 +1,33 @@
+/**
+  ******************************************************************************
+  * @file           : tcm.h
+  * @author         : Rusanov M.N.
+  * @version        : V1.0.0
+  * @date           : 16-Oct-2026
+  * @brief          : Placement of the hot paths into the tightly coupled
+  *                   memories. ITCM (0x00000000, 16K) runs the code with zero
+  *                   wait states regardless of the flash latency, DTCM
+  *                   (0x20000000, 64K) is never cached and is accessible
+  *                   by DMA, so the DMA buffers in it need no cache
+  *                   maintenance.
+  * @note           : The startup copies .itcm_text and .dtcm_data from flash
+  *                   and zeroes .dtcm_bss before SystemInit().
+  *                   The functions which can't be marked (HAL_UART_IRQHandler,
+  *                   the xprintf core) are placed by the linker script.
+  *                   Calls between flash and ITCM go through the long branch
+  *                   veneers made by the linker.
+  *                   tools/tcm_report.py checks the placement in the map file.
+  *
+  ******************************************************************************
+  */
+
+#pragma once
+
+// Places the function into ITCM
+#define ITCM_CODE __attribute__((section(".itcm_text")))
+
+// Places the initialized variable into DTCM
+#define DTCM_DATA __attribute__((section(".dtcm_data")))
+
+// Places the zero-initialized variable into DTCM
+#define DTCM_BSS __attribute__((section(".dtcm_bss")))
@@ -0,0 +1,157 @@
+/**
+  ******************************************************************************
+  * @file           : cmd_table_bench.cpp
+  * @author         : Rusanov M.N.
+  * @version        : V1.0.0
+  * @date           : 17-Oct-2026
+  * @brief          : Host benchmark of the keyword dispatch: the strncmp chain
+  *                   the command handler used before against the perfect
+  *                   hash of cmd_table, looked up at once and fed char by char
+  *                   as rtc_cmd_parser does. Every keyword and a few unknown
+  *                   ones are dispatched, the results are checked to match.
+  * @note           : The host times only rank the lookups, the chain costs
+  *                   grow with the number of commands on the target as well.
+  *
+  ******************************************************************************
+  */
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include "host_test.h"
+#include "cmd_table.h"
+#include "rtc_cmd_parser.h"
+
+namespace
+{
+  using parser = rtc_cmd_parser;
+  using rtc_cmd = parser::rtc_cmd;
+  using table_t = cmd_table<rtc_cmd, 16>;
+
+  constexpr int iterations = 1000000;
+
+  // Same keywords as rtc_cmd_parser::cmd_dispatch, in the order of the chain
+  constexpr table_t table{ {
+    table_t::make_entry(parser::cmd_set_t, rtc_cmd::SET_T),
+    table_t::make_entry(parser::cmd_set_d, rtc_cmd::SET_D),
+    table_t::make_entry(parser::cmd_set_dt, rtc_cmd::SET_DT),
+    table_t::make_entry(parser::cmd_get, rtc_cmd::GET),
+    table_t::make_entry(parser::cmd_get_ms, rtc_cmd::GET_MS),
+    table_t::make_entry(parser::cmd_get_wd, rtc_cmd::GET_WD),
+    table_t::make_entry(parser::cmd_get_epoch, rtc_cmd::GET_EPOCH),
+    table_t::make_entry(parser::cmd_subscribe, rtc_cmd::SUBSCRIBE),
+    table_t::make_entry(parser::cmd_unsubscribe, rtc_cmd::UNSUBSCRIBE),
+    table_t::make_entry(parser::cmd_alarm, rtc_cmd::ALARM),
+    table_t::make_entry(parser::cmd_alarm_del, rtc_cmd::ALARM_DEL),
+    table_t::make_entry(parser::cmd_dump_ts, rtc_cmd::DUMP_TS),
+    table_t::make_entry(parser::cmd_get_err, rtc_cmd::GET_ERR),
+    table_t::make_entry(parser::cmd_stack, rtc_cmd::STACK),
+    table_t::make_entry(parser::cmd_stats, rtc_cmd::STATS),
+    table_t::make_entry(parser::cmd_boot, rtc_cmd::BOOT)
+  } };
+  static_assert(table.is_valid(), "No perfect hash for the command keywords");
+
+  // A keyword whose static hash differs from the runtime one makes the table not valid
+  constexpr cmd_table<int, 1> wrong_hash_table{ { { "GET", 3, 0, parser::cmd_get.hash() + 1 } } };
+  static_assert(!wrong_hash_table.is_valid(), "The static and the runtime hashes are not compared");
+
+  const char* const inputs[] = {
+    "SET_T", "SET_D", "SET_DT", "GET", "GET_MS", "GET_WD", "GET_EPOCH", "SUBSCRIBE",
+    "UNSUBSCRIBE", "ALARM", "ALARM_DEL", "DUMP_TS", "GET_ERR", "STACK", "STATS",
+    "BOOT", "SUT_D", "GET_X", "STATSX", "HELLO"
+  };
+  constexpr size_t input_count = sizeof(inputs) / sizeof(inputs[0]);
+
+  volatile unsigned int sink; // Keeps the results alive
+
+  /**
+    * @brief  The strncmp chain: the keywords are compared in turn.
+    */
+  rtc_cmd chain_find(const char* keyword, const size_t length)
+  {
+    static const rtc_cmd cmds[] = {
+      rtc_cmd::SET_T, rtc_cmd::SET_D, rtc_cmd::SET_DT, rtc_cmd::GET, rtc_cmd::GET_MS,
+      rtc_cmd::GET_WD, rtc_cmd::GET_EPOCH, rtc_cmd::SUBSCRIBE, rtc_cmd::UNSUBSCRIBE,
+      rtc_cmd::ALARM, rtc_cmd::ALARM_DEL, rtc_cmd::DUMP_TS, rtc_cmd::GET_ERR,
+      rtc_cmd::STACK, rtc_cmd::STATS, rtc_cmd::BOOT
+    };
+
+    for (const rtc_cmd cmd : cmds)
+    {
+      const char* item = parser::keyword(cmd);
+      if ((std::strncmp(keyword, item, length) == 0) && (item[length] == '\0'))
+      {
+        return cmd;
+      }
+    }
+
+    return rtc_cmd::NONE;
+  }
+
+  rtc_cmd table_find(const char* keyword, const size_t length)
+  {
+    const rtc_cmd* cmd = table.find(keyword, length);
+    return (cmd != nullptr) ? *cmd : rtc_cmd::NONE;
+  }
+
+  /**
+    * @brief  As rtc_cmd_parser::on_keyword(): the prefix is checked and
+    *         the hash is updated on every char, then looked up once.
+    */
+  rtc_cmd table_feed(const char* keyword, const size_t length)
+  {
+    table_t::prefix range = table_t::all_keywords;
+    table_t::hasher hasher;
+
+    for (size_t pos = 0; pos < length; ++pos)
+    {
+      if (!table.extend(range, pos, keyword[pos]))
+      {
+        return rtc_cmd::NONE;
+      }
+
+      hasher.add(keyword[pos]);
+    }
+
+    const rtc_cmd* cmd = table.find(keyword, length, hasher.value());
+    return (cmd != nullptr) ? *cmd : rtc_cmd::NONE;
+  }
+
+  template<typename Find>
+  double ns_per_keyword(Find find)
+  {
+    size_t lengths[input_count] = {};
+    for (size_t i = 0; i < input_count; ++i)
+    {
+      lengths[i] = std::strlen(inputs[i]);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < iterations; ++i)
+    {
+      const size_t index = static_cast<size_t>(i) % input_count;
+      sink = static_cast<unsigned int>(find(inputs[index], lengths[index]));
+    }
+
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+  }
+}
+
+int main()
+{
+  for (const char* input : inputs)
+  {
+    const size_t length = std::strlen(input);
+    CHECK(chain_find(input, length) == table_find(input, length));
+    CHECK(chain_find(input, length) == table_feed(input, length));
+  }
+
+  std::printf("Dispatch of %zu keywords (%u slots): strncmp chain %5.1f ns, "
+              "perfect hash %5.1f ns, prefix + hash per char %5.1f ns\n",
+              input_count, static_cast<unsigned int>(table.slots()),
+              ns_per_keyword(chain_find), ns_per_keyword(table_find), ns_per_keyword(table_feed));
+
+  return host_test::result("cmd_table_bench");
+}
@@ -0,0 +1,110 @@
+/**
+  ******************************************************************************
+  * @file           : cycle_profile_test.cpp
+  * @author         : Rusanov M.N.
+  * @version        : V1.0.0
+  * @date           : 17-Oct-2026
+  * @brief          : Host test of the cycle probes and their histograms:
+  *                   CYCLE_PROBE on the stubbed DWT counter, its wrap,
+  *                   min/avg/max, the log2 buckets behind p99 and the text
+  *                   of the STATS report.
+  *
+  ******************************************************************************
+  */
+
+#include <string>
+#include "host_test.h"
+#include "cycle_profile.h"
+#include "xprintf.h"
+
+namespace
+{
+  std::string output; // Sent to UART by xprintf()
+
+  void capture(const int c)
+  {
+    output += static_cast<char>(c);
+  }
+
+  std::string report()
+  {
+    output.clear();
+    cycle_profile::get_instance().report();
+    return output;
+  }
+
+  /**
+    * @brief  A probed scope taking the cycles, as a command handler.
+    */
+  void probed(const size_t slot, const uint32_t start, const uint32_t cycles)
+  {
+    DWT->CYCCNT = start;
+    CYCLE_PROBE(slot, "probed");
+    DWT->CYCCNT = start + cycles;
+  }
+
+  void test_no_probes()
+  {
+    CHECK(report() == "Stats: no probes hit\r");
+  }
+
+  void test_probe()
+  {
+    probed(0, 1000, 40);
+    probed(0, 5000, 20);
+    probed(0, 0xFFFFFFF0U, 0x30); // CYCCNT wraps
+    CHECK(report() == "probed: 3 calls, min 20, avg 36, max 48, p99 48 cycles\r");
+  }
+
+  void test_percentile()
+  {
+    auto& profile = cycle_profile::get_instance();
+
+    // 1 of 100 is slow: p99 is the upper bound of the bucket 8...15
+    for (int i = 0; i < 99; ++i)
+    {
+      profile.add(1, "fast", 10);
+    }
+
+    profile.add(1, "fast", 5000);
+
+    // 2 of 100 are slow: p99 falls into their bucket, bounded by the max
+    for (int i = 0; i < 98; ++i)
+    {
+      profile.add(2, "slow", 10);
+    }
+
+    profile.add(2, "slow", 5000);
+    profile.add(2, "slow", 5000);
+
+    const std::string text = report();
+    CHECK(text.find("fast: 100 calls, min 10, avg 59, max 5000, p99 15 cycles\r") != std::string::npos);
+    CHECK(text.find("slow: 100 calls, min 10, avg 109, max 5000, p99 5000 cycles\r") != std::string::npos);
+  }
+
+  void test_extremes()
+  {
+    auto& profile = cycle_profile::get_instance();
+    profile.add(3, "zero", 0);
+    profile.add(4, "max", UINT32_MAX);
+    profile.add(cycle_profile::max_slots, "ignored", 1);
+
+    const std::string text = report();
+    CHECK(text.find("zero: 1 calls, min 0, avg 0, max 0, p99 0 cycles\r") != std::string::npos);
+    CHECK(text.find("max: 1 calls, min 4294967295, avg 4294967295, max 4294967295, p99 4294967295 cycles\r") !=
+          std::string::npos);
+    CHECK(text.find("ignored") == std::string::npos);
+  }
+}
+
+int main()
+{
+  xdev_out(capture);
+
+  test_no_probes();
+  test_probe();
+  test_percentile();
+  test_extremes();
+
+  return host_test::result("cycle_profile_test");
+}
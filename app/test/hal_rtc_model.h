@@ -0,0 +1,78 @@
+/**
+  ******************************************************************************
+  * @file           : hal_rtc_model.h
+  * @author         : Rusanov M.N.
+  * @version        : V1.0.0
+  * @date           : 17-Oct-2026
+  * @brief          : Host model of the HAL calendar reads which rtc_snapshot
+  *                   has replaced: the register fields are converted from BCD
+  *                   as HAL_RTC_GetTime()/HAL_RTC_GetDate() do with
+  *                   RTC_FORMAT_BIN. The registers are held in a snapshot.
+  *
+  ******************************************************************************
+  */
+
+#pragma once
+
+#include "rtc_snapshot.h"
+
+namespace hal_rtc_model
+{
+  constexpr uint32_t prediv_s = 255; // As hrtc.Init.SynchPrediv
+
+  inline uint8_t bcd_to_byte(const uint32_t value)
+  {
+    return static_cast<uint8_t>((value >> 4) * 10 + (value & 0x0F));
+  }
+
+  inline uint32_t byte_to_bcd(const uint32_t value)
+  {
+    return ((value / 10) << 4) | (value % 10);
+  }
+
+  /**
+    * @brief  The registers as the RTC keeps the time and date.
+    */
+  inline rtc_snapshot make_snapshot(const RTC_DateTypeDef& date, const RTC_TimeTypeDef& time, const uint32_t ssr)
+  {
+    rtc_snapshot result;
+    result.ssr = ssr;
+    result.tr = (byte_to_bcd(time.Hours) << RTC_TR_HU_Pos) |
+                (byte_to_bcd(time.Minutes) << RTC_TR_MNU_Pos) |
+                (byte_to_bcd(time.Seconds) << RTC_TR_SU_Pos);
+    result.dr = (byte_to_bcd(date.Year) << RTC_DR_YU_Pos) |
+                (static_cast<uint32_t>(date.WeekDay) << RTC_DR_WDU_Pos) |
+                (byte_to_bcd(date.Month) << RTC_DR_MU_Pos) |
+                (byte_to_bcd(date.Date) << RTC_DR_DU_Pos);
+    result.second_fraction = prediv_s;
+    return result;
+  }
+
+  /**
+    * @brief  Same conversions as HAL_RTC_GetTime() with RTC_FORMAT_BIN.
+    */
+  inline RTC_TimeTypeDef hal_get_time(const rtc_snapshot& regs)
+  {
+    RTC_TimeTypeDef result = {};
+    result.SubSeconds = regs.ssr;
+    result.SecondFraction = regs.second_fraction;
+    result.Hours = bcd_to_byte((regs.tr & (RTC_TR_HT | RTC_TR_HU)) >> RTC_TR_HU_Pos);
+    result.Minutes = bcd_to_byte((regs.tr & (RTC_TR_MNT | RTC_TR_MNU)) >> RTC_TR_MNU_Pos);
+    result.Seconds = bcd_to_byte(regs.tr & (RTC_TR_ST | RTC_TR_SU));
+    result.TimeFormat = static_cast<uint8_t>((regs.tr & RTC_TR_PM) >> RTC_TR_PM_Pos);
+    return result;
+  }
+
+  /**
+    * @brief  Same conversions as HAL_RTC_GetDate() with RTC_FORMAT_BIN.
+    */
+  inline RTC_DateTypeDef hal_get_date(const rtc_snapshot& regs)
+  {
+    RTC_DateTypeDef result = {};
+    result.Year = bcd_to_byte((regs.dr & (RTC_DR_YT | RTC_DR_YU)) >> RTC_DR_YU_Pos);
+    result.Month = bcd_to_byte((regs.dr & (RTC_DR_MT | RTC_DR_MU)) >> RTC_DR_MU_Pos);
+    result.Date = bcd_to_byte(regs.dr & (RTC_DR_DT | RTC_DR_DU));
+    result.WeekDay = static_cast<uint8_t>((regs.dr & RTC_DR_WDU) >> RTC_DR_WDU_Pos);
+    return result;
+  }
+}
@@ -0,0 +1,47 @@
+/**
+  ******************************************************************************
+  * @file           : host_test.h
+  * @author         : Rusanov M.N.
+  * @version        : V1.0.0
+  * @date           : 17-Oct-2026
+  * @brief          : Checks of the host tests in this directory.
+  *                   CHECK(expr) reports the failed expression with its line
+  *                   and counts it, host_test::result() is the exit code of
+  *                   the test program.
+  * @note           : The tests are built and run on the host by the Makefile
+  *                   of this directory, they don't depend on the HAL.
+  *
+  ******************************************************************************
+  */
+
+#pragma once
+
+#include <cstdio>
+
+namespace host_test
+{
+  inline int failures = 0;
+  inline int checks = 0;
+
+  inline void check(const bool ok, const char* expr, const char* file, const int line)
+  {
+    ++checks;
+
+    if (!ok)
+    {
+      ++failures;
+      std::printf("%s:%d: CHECK(%s) failed\n", file, line, expr);
+    }
+  }
+
+  /**
+    * @retval Exit code of the test: 0 if all checks have passed.
+    */
+  inline int result(const char* name)
+  {
+    std::printf("%s: %d checks, %d failed\n", name, checks, failures);
+    return (failures == 0) ? 0 : 1;
+  }
+}
+
+#define CHECK(expr) host_test::check((expr), #expr, __FILE__, __LINE__)
@@ -0,0 +1,128 @@
+/**
+  ******************************************************************************
+  * @file           : main.h
+  * @author         : Rusanov M.N.
+  * @version        : V1.0.0
+  * @date           : 17-Oct-2026
+  * @brief          : Host stub of Core/Inc/main.h for the tests: the part of
+  *                   the STM32F746 CMSIS and HAL used by rtc_snapshot,
+  *                   rtc_calendar and cycle_profile. The register fields are
+  *                   copied from stm32f746xx.h and stm32f7xx_hal_rtc.h.
+  *                   The registers are plain memory set by the test, the DWT
+  *                   cycle counter is advanced by the test as well.
+  *
+  ******************************************************************************
+  */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#define __IO volatile
+
+typedef struct
+{
+  __IO uint32_t TR;
+  __IO uint32_t DR;
+  __IO uint32_t CR;
+  __IO uint32_t ISR;
+  __IO uint32_t PRER;
+  __IO uint32_t WUTR;
+  uint32_t reserved;
+  __IO uint32_t ALRMAR;
+  __IO uint32_t ALRMBR;
+  __IO uint32_t WPR;
+  __IO uint32_t SSR;
+} RTC_TypeDef;
+
+typedef struct
+{
+  __IO uint32_t CTRL;
+  __IO uint32_t CYCCNT;
+} DWT_Type;
+
+inline DWT_Type dwt_stub;
+#define DWT (&dwt_stub)
+
+#define __CLZ(value) static_cast<uint8_t>(__builtin_clz(value))
+
+#define RTC_TR_PM_Pos                  (22U)
+#define RTC_TR_PM_Msk                  (0x1UL << RTC_TR_PM_Pos)
+#define RTC_TR_PM                      RTC_TR_PM_Msk
+#define RTC_TR_HT_Pos                  (20U)
+#define RTC_TR_HT_Msk                  (0x3UL << RTC_TR_HT_Pos)
+#define RTC_TR_HT                      RTC_TR_HT_Msk
+#define RTC_TR_HU_Pos                  (16U)
+#define RTC_TR_HU_Msk                  (0xFUL << RTC_TR_HU_Pos)
+#define RTC_TR_HU                      RTC_TR_HU_Msk
+#define RTC_TR_MNT_Pos                 (12U)
+#define RTC_TR_MNT_Msk                 (0x7UL << RTC_TR_MNT_Pos)
+#define RTC_TR_MNT                     RTC_TR_MNT_Msk
+#define RTC_TR_MNU_Pos                 (8U)
+#define RTC_TR_MNU_Msk                 (0xFUL << RTC_TR_MNU_Pos)
+#define RTC_TR_MNU                     RTC_TR_MNU_Msk
+#define RTC_TR_ST_Pos                  (4U)
+#define RTC_TR_ST_Msk                  (0x7UL << RTC_TR_ST_Pos)
+#define RTC_TR_ST                      RTC_TR_ST_Msk
+#define RTC_TR_SU_Pos                  (0U)
+#define RTC_TR_SU_Msk                  (0xFUL << RTC_TR_SU_Pos)
+#define RTC_TR_SU                      RTC_TR_SU_Msk
+
+#define RTC_DR_YT_Pos                  (20U)
+#define RTC_DR_YT_Msk                  (0xFUL << RTC_DR_YT_Pos)
+#define RTC_DR_YT                      RTC_DR_YT_Msk
+#define RTC_DR_YU_Pos                  (16U)
+#define RTC_DR_YU_Msk                  (0xFUL << RTC_DR_YU_Pos)
+#define RTC_DR_YU                      RTC_DR_YU_Msk
+#define RTC_DR_WDU_Pos                 (13U)
+#define RTC_DR_WDU_Msk                 (0x7UL << RTC_DR_WDU_Pos)
+#define RTC_DR_WDU                     RTC_DR_WDU_Msk
+#define RTC_DR_MT_Pos                  (12U)
+#define RTC_DR_MT_Msk                  (0x1UL << RTC_DR_MT_Pos)
+#define RTC_DR_MT                      RTC_DR_MT_Msk
+#define RTC_DR_MU_Pos                  (8U)
+#define RTC_DR_MU_Msk                  (0xFUL << RTC_DR_MU_Pos)
+#define RTC_DR_MU                      RTC_DR_MU_Msk
+#define RTC_DR_DT_Pos                  (4U)
+#define RTC_DR_DT_Msk                  (0x3UL << RTC_DR_DT_Pos)
+#define RTC_DR_DT                      RTC_DR_DT_Msk
+#define RTC_DR_DU_Pos                  (0U)
+#define RTC_DR_DU_Msk                  (0xFUL << RTC_DR_DU_Pos)
+#define RTC_DR_DU                      RTC_DR_DU_Msk
+
+#define RTC_CR_BYPSHAD_Pos             (5U)
+#define RTC_CR_BYPSHAD_Msk             (0x1UL << RTC_CR_BYPSHAD_Pos)
+#define RTC_CR_BYPSHAD                 RTC_CR_BYPSHAD_Msk
+
+#define RTC_PRER_PREDIV_S_Pos          (0U)
+#define RTC_PRER_PREDIV_S_Msk          (0x7FFFUL << RTC_PRER_PREDIV_S_Pos)
+#define RTC_PRER_PREDIV_S              RTC_PRER_PREDIV_S_Msk
+
+#define RTC_WEEKDAY_MONDAY             ((uint8_t)0x01)
+#define RTC_WEEKDAY_TUESDAY            ((uint8_t)0x02)
+#define RTC_WEEKDAY_WEDNESDAY          ((uint8_t)0x03)
+#define RTC_WEEKDAY_THURSDAY           ((uint8_t)0x04)
+#define RTC_WEEKDAY_FRIDAY             ((uint8_t)0x05)
+#define RTC_WEEKDAY_SATURDAY           ((uint8_t)0x06)
+#define RTC_WEEKDAY_SUNDAY             ((uint8_t)0x07)
+
+typedef struct
+{
+  uint8_t Hours;
+  uint8_t Minutes;
+  uint8_t Seconds;
+  uint8_t TimeFormat;
+  uint32_t SubSeconds;
+  uint32_t SecondFraction;
+  uint32_t DayLightSaving;
+  uint32_t StoreOperation;
+} RTC_TimeTypeDef;
+
+typedef struct
+{
+  uint8_t WeekDay;
+  uint8_t Month;
+  uint8_t Date;
+  uint8_t Year;
+} RTC_DateTypeDef;
@@ -0,0 +1,133 @@
+/**
+  ******************************************************************************
+  * @file           : rtc_calendar_test.cpp
+  * @author         : Rusanov M.N.
+  * @version        : V1.0.0
+  * @date           : 17-Oct-2026
+  * @brief          : Host test of the calendar of the RTC years 2000...2099:
+  *                   is_valid_date(), day_of_year() and weekday() of every
+  *                   date against gmtime() of the C library, and the clamping
+  *                   of fix_date() for every day and month out of range.
+  *
+  ******************************************************************************
+  */
+
+#include <ctime>
+#include <initializer_list>
+#include "host_test.h"
+#include "rtc_calendar.h"
+
+namespace
+{
+  // Reference, independent of the tables of rtc_calendar
+  uint8_t reference_days_in_month(const int year, const int month)
+  {
+    static const uint8_t days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    const bool leap = ((year % 4) == 0) && (((year % 100) != 0) || ((year % 400) == 0));
+    return static_cast<uint8_t>(days[month - 1] + (((month == 2) && leap) ? 1 : 0));
+  }
+
+  uint8_t reference_clamp(const uint8_t value, const uint8_t max, const bool set_max)
+  {
+    return (value < 1) ? 1 : ((value > max) ? (set_max ? max : 1) : value);
+  }
+
+  void test_every_date()
+  {
+    const std::time_t first_s = static_cast<std::time_t>(rtc_calendar::days_from_civil(2000, 1, 1)) * 86400;
+    const std::time_t end_s = static_cast<std::time_t>(rtc_calendar::days_from_civil(2100, 1, 1)) * 86400;
+    bool valid = true;
+    bool kept = true;
+    bool ordinal = true;
+    bool weekdays = true;
+    uint32_t dates = 0;
+
+    for (std::time_t s = first_s; s < end_s; s += 86400)
+    {
+      std::tm tm = {};
+      gmtime_r(&s, &tm);
+
+      RTC_DateTypeDef date = {};
+      date.Year = static_cast<uint8_t>(tm.tm_year + 1900 - rtc_calendar::rtc_base_year);
+      date.Month = static_cast<uint8_t>(tm.tm_mon + 1);
+      date.Date = static_cast<uint8_t>(tm.tm_mday);
+      const RTC_DateTypeDef sent = date;
+
+      valid = valid && rtc_calendar::is_valid_date(date);
+      kept = kept && rtc_calendar::fix_date(date, true) && (date.Year == sent.Year) &&
+             (date.Month == sent.Month) && (date.Date == sent.Date);
+      ordinal = ordinal && (rtc_calendar::day_of_year(date) == tm.tm_yday + 1);
+      weekdays = weekdays && (rtc_calendar::weekday(date) == ((tm.tm_wday == 0) ? RTC_WEEKDAY_SUNDAY : tm.tm_wday));
+      ++dates;
+    }
+
+    CHECK(dates == 36525);
+    CHECK(valid);
+    CHECK(kept);
+    CHECK(ordinal);
+    CHECK(weekdays);
+  }
+
+  void test_fix_date()
+  {
+    bool valid = true;
+    bool clamped = true;
+    bool fixed = true;
+
+    for (uint8_t year = 0; year < rtc_calendar::rtc_years; ++year)
+    {
+      for (uint8_t month = 0; month <= 15; ++month)
+      {
+        for (uint8_t day = 0; day <= 40; ++day)
+        {
+          const int full_year = rtc_calendar::rtc_base_year + year;
+          const bool reference_valid = (month >= 1) && (month <= 12) &&
+                                       (day >= 1) && (day <= reference_days_in_month(full_year, month));
+
+          for (const bool set_max : { false, true })
+          {
+            RTC_DateTypeDef date = {};
+            date.Year = year;
+            date.Month = month;
+            date.Date = day;
+
+            valid = valid && (rtc_calendar::is_valid_date(date) == reference_valid);
+            fixed = fixed && (rtc_calendar::fix_date(date, set_max) == reference_valid);
+
+            const uint8_t expected_month = reference_clamp(month, 12, set_max);
+            const uint8_t expected_day = reference_clamp(day, reference_days_in_month(full_year, expected_month),
+                                                         set_max);
+            clamped = clamped && (date.Year == year) && (date.Month == expected_month) &&
+                      (date.Date == expected_day) && rtc_calendar::is_valid_date(date);
+          }
+        }
+      }
+    }
+
+    CHECK(valid);
+    CHECK(fixed);
+    CHECK(clamped);
+
+    // The 29 February of a year that is not leap, by the set_max rule
+    RTC_DateTypeDef date = { 0, 2, 29, 23 };
+    CHECK(!rtc_calendar::fix_date(date, true));
+    CHECK((date.Month == 2) && (date.Date == 28));
+
+    date = { 0, 2, 29, 23 };
+    CHECK(!rtc_calendar::fix_date(date, false));
+    CHECK((date.Month == 2) && (date.Date == 1));
+
+    // The years out of the RTC range wrap by 100
+    date = { 0, 12, 31, 199 };
+    CHECK(!rtc_calendar::fix_date(date, true));
+    CHECK((date.Year == 99) && (date.Month == 12) && (date.Date == 31));
+  }
+}
+
+int main()
+{
+  test_every_date();
+  test_fix_date();
+
+  return host_test::result("rtc_calendar_test");
+}
@@ -0,0 +1,417 @@
+/**
+  ******************************************************************************
+  * @file           : rtc_cmd_parser_test.cpp
+  * @author         : Rusanov M.N.
+  * @version        : V1.0.0
+  * @date           : 17-Oct-2026
+  * @brief          : Host test of the streaming command parser: valid
+  *                   commands, ';' batches, truncated and overlong msgs,
+  *                   per-field overflow, trailing text and a fuzz run
+  *                   checking the invariants of the state machine.
+  *
+  ******************************************************************************
+  */
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <regex>
+#include <string>
+#include <vector>
+#include "host_test.h"
+#include "rtc_cmd_parser.h"
+
+namespace
+{
+  using rtc_cmd = rtc_cmd_parser::rtc_cmd;
+  using cmd_err = rtc_cmd_parser::cmd_err;
+  using cmd_info = rtc_cmd_parser::cmd_info;
+
+  std::vector<cmd_info> feed(rtc_cmd_parser& parser, const char* msg)
+  {
+    std::vector<cmd_info> result;
+
+    for (; *msg != '\0'; ++msg)
+    {
+      if (cmd_info info = {}; parser.feed(*msg, info))
+      {
+        result.push_back(info);
+      }
+    }
+
+    return result;
+  }
+
+  std::vector<cmd_info> parse(const char* msg)
+  {
+    rtc_cmd_parser parser;
+    return feed(parser, msg);
+  }
+
+  /**
+    * @retval true if the msg gives one command with the error and the args.
+    */
+  bool parses_to(const char* msg, const rtc_cmd cmd, const cmd_err err,
+                 const std::vector<uint16_t>& args = {})
+  {
+    const std::vector<cmd_info> result = parse(msg);
+    if ((result.size() != 1) || (result[0].err != err) || ((err == cmd_err::OK) && (result[0].cmd != cmd)))
+    {
+      return false;
+    }
+
+    for (size_t i = 0; i < args.size(); ++i)
+    {
+      if (result[0].args[i] != args[i])
+      {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  bool rejects(const char* msg, const cmd_err err)
+  {
+    const std::vector<cmd_info> result = parse(msg);
+    return (result.size() == 1) && (result[0].err == err);
+  }
+
+  void test_valid_commands()
+  {
+    CHECK(parses_to("SET_T 12:34:56\r", rtc_cmd::SET_T, cmd_err::OK, { 12, 34, 56 }));
+    CHECK(parses_to("SET_T 1:2:3\r", rtc_cmd::SET_T, cmd_err::OK, { 1, 2, 3 }));
+    CHECK(parses_to("SET_T  7: 8: 9\r", rtc_cmd::SET_T, cmd_err::OK, { 7, 8, 9 }));
+    CHECK(parses_to("SET_D 09/05/2024\r", rtc_cmd::SET_D, cmd_err::OK, { 9, 5, 2024 }));
+    CHECK(parses_to("SET_DT 31/12/2099 23:59:59\r", rtc_cmd::SET_DT, cmd_err::OK, { 31, 12, 2099, 23, 59, 59 }));
+    CHECK(parses_to("GET\r", rtc_cmd::GET, cmd_err::OK));
+    CHECK(parses_to("GET_MS\r", rtc_cmd::GET_MS, cmd_err::OK));
+    CHECK(parses_to("GET_WD\r", rtc_cmd::GET_WD, cmd_err::OK));
+    CHECK(parses_to("GET_EPOCH\r", rtc_cmd::GET_EPOCH, cmd_err::OK));
+    CHECK(parses_to("SUBSCRIBE 100\r", rtc_cmd::SUBSCRIBE, cmd_err::OK, { 100 }));
+    CHECK(parses_to("UNSUBSCRIBE\r", rtc_cmd::UNSUBSCRIBE, cmd_err::OK));
+    CHECK(parses_to("ALARM 01/02/2030 04:05:06\r", rtc_cmd::ALARM, cmd_err::OK, { 1, 2, 2030, 4, 5, 6 }));
+    CHECK(parses_to("ALARM_DEL 7\r", rtc_cmd::ALARM_DEL, cmd_err::OK, { 7 }));
+    CHECK(parses_to("DUMP_TS\r", rtc_cmd::DUMP_TS, cmd_err::OK));
+    CHECK(parses_to("GET_ERR\r", rtc_cmd::GET_ERR, cmd_err::OK));
+    CHECK(parses_to("STACK\r", rtc_cmd::STACK, cmd_err::OK));
+    CHECK(parses_to("STATS\r", rtc_cmd::STATS, cmd_err::OK));
+    CHECK(parses_to("BOOT\r", rtc_cmd::BOOT, cmd_err::OK));
+
+    for (size_t i = 0; i < static_cast<size_t>(rtc_cmd::NONE); ++i)
+    {
+      CHECK(std::strlen(rtc_cmd_parser::keyword(static_cast<rtc_cmd>(i))) > 0);
+    }
+
+    CHECK(std::strlen(rtc_cmd_parser::keyword(rtc_cmd::NONE)) == 0);
+  }
+
+  void test_batches()
+  {
+    rtc_cmd_parser parser;
+    CHECK(parser.is_idle());
+
+    std::vector<cmd_info> result = feed(parser, "GET;GET_MS;");
+    CHECK(result.size() == 2);
+    CHECK(!parser.is_idle()); // The msg goes on after ';'
+
+    result = feed(parser, "SET_T 01:02:03\r");
+    CHECK(result.size() == 1);
+    CHECK((result[0].cmd == rtc_cmd::SET_T) && (result[0].err == cmd_err::OK) && (result[0].args[2] == 3));
+    CHECK(parser.is_idle());
+
+    // A wrong command doesn't affect its neighbours
+    result = parse("GET;FOO;SUBSCRIBE 50\r");
+    CHECK(result.size() == 3);
+    CHECK((result[0].cmd == rtc_cmd::GET) && (result[0].err == cmd_err::OK));
+    CHECK(result[1].err == cmd_err::WRONG_CMD);
+    CHECK((result[2].cmd == rtc_cmd::SUBSCRIBE) && (result[2].err == cmd_err::OK) && (result[2].args[0] == 50));
+
+    // Empty commands are ignored
+    CHECK(parse(";;\r").empty());
+    CHECK(parse("\r").empty());
+    CHECK(parse(";GET;;\r").size() == 1);
+  }
+
+  void test_truncated()
+  {
+    CHECK(rejects("SET_T 12:34\r", cmd_err::WRONG_FORMAT));
+    CHECK(rejects("SET_T 12:34:\r", cmd_err::WRONG_FORMAT));
+    CHECK(rejects("SET_T \r", cmd_err::WRONG_FORMAT));
+    CHECK(rejects("SET_T\r", cmd_err::WRONG_CMD)); // The argument is missing
+    CHECK(rejects("SET_D 09/05\r", cmd_err::WRONG_FORMAT));
+    CHECK(rejects("SET_DT 31/12/2099\r", cmd_err::WRONG_FORMAT));
+    CHECK(rejects("GE\r", cmd_err::WRONG_CMD));
+    CHECK(rejects("GET_\r", cmd_err::WRONG_CMD));
+
+    // The parser recovers on the next command
+    rtc_cmd_parser parser;
+    CHECK(feed(parser, "SET_T 12:").empty());
+    parser.reset(); // As on the reception time-out
+    const std::vector<cmd_info> result = feed(parser, "GET\r");
+    CHECK((result.size() == 1) && (result[0].cmd == rtc_cmd::GET) && (result[0].err == cmd_err::OK));
+  }
+
+  void test_overlong()
+  {
+    static_assert(sizeof("SET_DT 31/12/2099 23:59:59") - 1 == rtc_cmd_parser::max_msg_length);
+    CHECK(rejects("SET_DT  31/12/2099 23:59:59\r", cmd_err::SIZE_EXCEEDED));
+    CHECK(rejects("SET_T 12:34:56      \r", cmd_err::WRONG_FORMAT));
+    CHECK(rejects("SET_T 123:00:00\r", cmd_err::WRONG_FORMAT));
+    CHECK(rejects("SET_D 09/05/20245\r", cmd_err::WRONG_FORMAT));
+    CHECK(rejects("SUBSCRIBE 000100\r", cmd_err::WRONG_FORMAT));
+
+    // The rest of the rejected msg is skipped up to its end
+    rtc_cmd_parser parser;
+    std::vector<cmd_info> result = feed(parser, "SET_DT  31/12/2099 23:59:59 and more;GET\r");
+    CHECK(result.size() == 2);
+    CHECK(result[0].err == cmd_err::SIZE_EXCEEDED);
+    CHECK((result[1].cmd == rtc_cmd::GET) && (result[1].err == cmd_err::OK));
+    CHECK(parser.is_idle());
+  }
+
+  void test_field_overflow()
+  {
+    CHECK(parses_to("SUBSCRIBE 65535\r", rtc_cmd::SUBSCRIBE, cmd_err::OK, { 65535 }));
+    CHECK(rejects("SUBSCRIBE 65536\r", cmd_err::WRONG_FORMAT));
+    CHECK(rejects("SUBSCRIBE 65546\r", cmd_err::WRONG_FORMAT)); // Wrapped to 10 before
+    CHECK(rejects("SUBSCRIBE 99999\r", cmd_err::WRONG_FORMAT));
+    CHECK(parses_to("ALARM_DEL 65535\r", rtc_cmd::ALARM_DEL, cmd_err::OK, { 65535 }));
+    CHECK(rejects("ALARM_DEL 65537\r", cmd_err::WRONG_FORMAT)); // Wrapped to 1 before
+
+    const std::vector<cmd_info> result = parse("ALARM_DEL 70000\r");
+    CHECK((result.size() == 1) && (result[0].cmd == rtc_cmd::ALARM_DEL)); // Reported as a wrong id format
+    CHECK(parses_to("SET_D 99/99/9999\r", rtc_cmd::SET_D, cmd_err::OK, { 99, 99, 9999 })); // Fixed by rtc_internal
+  }
+
+  /**
+    * @note   Unlike the sscanf() parsing it has replaced, the command must end
+    *         right after its argument: trailing text rejects it.
+    */
+  void test_trailing_text()
+  {
+    CHECK(rejects("GET \r", cmd_err::WRONG_CMD));
+    CHECK(rejects("GET x\r", cmd_err::WRONG_CMD));
+    CHECK(rejects("GETX\r", cmd_err::WRONG_CMD));
+    CHECK(rejects("SET_T 12:00:00 x\r", cmd_err::WRONG_FORMAT));
+    CHECK(rejects("SET_T 12:00:00x\r", cmd_err::WRONG_FORMAT));
+    CHECK(rejects("SET_D 09/05/2024 \r", cmd_err::WRONG_FORMAT));
+    CHECK(rejects("SET_T12:00:00\r", cmd_err::WRONG_CMD));
+  }
+
+  void test_wrong_keywords()
+  {
+    CHECK(rejects("get\r", cmd_err::WRONG_CMD));
+    CHECK(rejects("SUT_D 09/05/2024\r", cmd_err::WRONG_CMD));
+    CHECK(rejects("SET_X 1\r", cmd_err::WRONG_CMD));
+    CHECK(rejects("XYZ\r", cmd_err::WRONG_CMD));
+    CHECK(rejects(" GET\r", cmd_err::WRONG_CMD));
+    CHECK(rejects("SET_T 12-00-00\r", cmd_err::WRONG_FORMAT));
+
+    // Rejected on the first char which no keyword has after the prefix
+    CHECK(rejects("SUT", cmd_err::WRONG_CMD));
+    CHECK(rejects("SET_DX", cmd_err::WRONG_CMD));
+    CHECK(rejects("GET_EPOCHS", cmd_err::WRONG_CMD));
+    CHECK(rejects("UNSUBSCRIBE_", cmd_err::WRONG_CMD));
+    CHECK(parse("SET_").empty());
+    CHECK(parse("UNSUBSCRIB").empty());
+  }
+
+  /**
+    * @brief  Reference of the command syntax, independent of the parser:
+    *         the keyword, then the fields of the template, each of leading
+    *         spaces and 1 up to the placeholder run length digits.
+    * @retval true if the command (without its end char) is well formed,
+    *         its cmd and fields are returned in result.
+    */
+  bool reference_parse(const std::string& text, cmd_info& result)
+  {
+    static const char* const field_1_2 = " *([0-9]{1,2})";
+    static const char* const field_1_4 = " *([0-9]{1,4})";
+    static const char* const field_1_5 = " *([0-9]{1,5})";
+    static const std::string time = std::string(field_1_2) + ":" + field_1_2 + ":" + field_1_2;
+    static const std::string date = std::string(field_1_2) + "/" + field_1_2 + "/" + field_1_4;
+    static const struct
+    {
+      rtc_cmd cmd;
+      std::regex syntax;
+    } commands[] = {
+      { rtc_cmd::SET_T, std::regex("SET_T " + time) },
+      { rtc_cmd::SET_D, std::regex("SET_D " + date) },
+      { rtc_cmd::SET_DT, std::regex("SET_DT " + date + " " + time) },
+      { rtc_cmd::GET, std::regex("GET") },
+      { rtc_cmd::GET_MS, std::regex("GET_MS") },
+      { rtc_cmd::GET_WD, std::regex("GET_WD") },
+      { rtc_cmd::GET_EPOCH, std::regex("GET_EPOCH") },
+      { rtc_cmd::SUBSCRIBE, std::regex(std::string("SUBSCRIBE ") + field_1_5) },
+      { rtc_cmd::UNSUBSCRIBE, std::regex("UNSUBSCRIBE") },
+      { rtc_cmd::ALARM, std::regex("ALARM " + date + " " + time) },
+      { rtc_cmd::ALARM_DEL, std::regex(std::string("ALARM_DEL ") + field_1_5) },
+      { rtc_cmd::DUMP_TS, std::regex("DUMP_TS") },
+      { rtc_cmd::GET_ERR, std::regex("GET_ERR") },
+      { rtc_cmd::STACK, std::regex("STACK") },
+      { rtc_cmd::STATS, std::regex("STATS") },
+      { rtc_cmd::BOOT, std::regex("BOOT") }
+    };
+
+    if (text.size() > rtc_cmd_parser::max_msg_length)
+    {
+      return false;
+    }
+
+    for (const auto& item : commands)
+    {
+      std::smatch match;
+      if (!std::regex_match(text, match, item.syntax))
+      {
+        continue;
+      }
+
+      result = { item.cmd, cmd_err::OK, {} };
+      for (size_t i = 1; i < match.size(); ++i)
+      {
+        const unsigned long value = std::stoul(match[i].str());
+        if (value > UINT16_MAX)
+        {
+          return false;
+        }
+
+        result.args[i - 1] = static_cast<uint16_t>(value);
+      }
+
+      return true;
+    }
+
+    return false;
+  }
+
+  bool same_cmd(const cmd_info& lhs, const cmd_info& rhs)
+  {
+    return (lhs.cmd == rhs.cmd) && (lhs.err == rhs.err) &&
+           std::equal(std::begin(lhs.args), std::end(lhs.args), std::begin(rhs.args));
+  }
+
+  /**
+    * @brief  Feeds random msgs made of the keywords, args and noise.
+    *         The parser must never report more commands than were ended,
+    *         a command reported as OK must match the command sent as
+    *         checked by @ref reference_parse(), every well formed command
+    *         must be reported as OK, and the parser must be idle after
+    *         every '\r'.
+    */
+  void test_fuzz()
+  {
+    static const char* const pieces[] = {
+      "SET_T", "SET_D", "SET_DT", "GET", "GET_MS", "GET_WD", "GET_EPOCH", "SUBSCRIBE",
+      "UNSUBSCRIBE", "ALARM", "ALARM_DEL", "DUMP_TS", "GET_ERR", "STACK", "STATS",
+      "BOOT", " ", "  ", ":", "/", "0", "1", "59", "99", "2024", "65535", "65536", "99999",
+      ";", "\r", "x", "_", "\xff", "\0"
+    };
+    constexpr size_t piece_count = sizeof(pieces) / sizeof(pieces[0]);
+
+    uint32_t seed = 12345;
+    const auto random = [&seed](const uint32_t range)
+    {
+      seed = seed * 1664525U + 1013904223U;
+      return (seed >> 8) % range;
+    };
+
+    rtc_cmd_parser parser;
+    size_t ends = 0;
+    size_t results = 0;
+    size_t well_formed = 0;
+    std::string sent; // The command being sent, since the last end char
+    bool ok = true;
+    bool matches = true;
+
+    for (int round = 0; round < 200000; ++round)
+    {
+      const char* piece = pieces[random(piece_count)];
+      const size_t length = (*piece == '\0') ? 1 : std::strlen(piece);
+
+      for (size_t i = 0; i < length; ++i)
+      {
+        const char c = piece[i];
+        const bool is_end = (c == rtc_cmd_parser::end_char) || (c == rtc_cmd_parser::cmd_separator);
+        cmd_info info = {};
+        const bool has_result = parser.feed(c, info);
+
+        if (has_result)
+        {
+          ++results;
+          ok = ok && (info.err <= cmd_err::SIZE_EXCEEDED);
+          ok = ok && ((info.err != cmd_err::OK) || (info.cmd < rtc_cmd::NONE));
+          ok = ok && ((info.err != cmd_err::OK) || is_end);
+        }
+
+        if (!is_end)
+        {
+          sent += c;
+          continue;
+        }
+
+        ++ends;
+        ok = ok && (results <= ends);
+
+        cmd_info expected = {};
+        if (reference_parse(sent, expected))
+        {
+          ++well_formed;
+          matches = matches && has_result && same_cmd(info, expected);
+        }
+        else
+        {
+          matches = matches && (!has_result || (info.err != cmd_err::OK));
+        }
+
+        sent.clear();
+
+        if (c == rtc_cmd_parser::end_char)
+        {
+          ok = ok && parser.is_idle();
+        }
+      }
+    }
+
+    CHECK(ok);
+    CHECK(matches);
+    CHECK(results > 0);
+    CHECK(well_formed > 0);
+
+    // Random valid commands must parse to their fields
+    parser.reset();
+    bool round_trip = true;
+    for (int round = 0; round < 10000; ++round)
+    {
+      const auto hours = static_cast<uint16_t>(random(100));
+      const auto minutes = static_cast<uint16_t>(random(100));
+      const auto seconds = static_cast<uint16_t>(random(100));
+      const auto period = static_cast<uint16_t>(random(65536));
+
+      char msg[64];
+      std::snprintf(msg, sizeof(msg), "SET_T %u:%02u:%u;SUBSCRIBE %u\r", hours, minutes, seconds, period);
+
+      const std::vector<cmd_info> result = feed(parser, msg);
+      round_trip = round_trip && (result.size() == 2) &&
+                   (result[0].err == cmd_err::OK) && (result[0].args[0] == hours) &&
+                   (result[0].args[1] == minutes) && (result[0].args[2] == seconds) &&
+                   (result[1].err == cmd_err::OK) && (result[1].args[0] == period);
+    }
+
+    CHECK(round_trip);
+  }
+}
+
+int main()
+{
+  test_valid_commands();
+  test_batches();
+  test_truncated();
+  test_overlong();
+  test_field_overflow();
+  test_trailing_text();
+  test_wrong_keywords();
+  test_fuzz();
+
+  return host_test::result("rtc_cmd_parser_test");
+}
@@ -0,0 +1,103 @@
+/**
+  ******************************************************************************
+  * @file           : rtc_snapshot_bench.cpp
+  * @author         : Rusanov M.N.
+  * @version        : V1.0.0
+  * @date           : 17-Oct-2026
+  * @brief          : Host benchmark of the time read path of print_time():
+  *                   the HAL conversions with xsprintf() as before, against
+  *                   the direct register reads of rtc_snapshot.
+  *                   The texts of both paths are checked to match.
+  * @note           : The host times only rank the paths. The cycles on the
+  *                   target are reported by the STATS command for GET and
+  *                   GET_MS, see cycle_profile.h.
+  *
+  ******************************************************************************
+  */
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include "hal_rtc_model.h"
+#include "host_test.h"
+#include "xprintf.h"
+
+namespace
+{
+  using namespace hal_rtc_model;
+
+  constexpr int iterations = 1000000;
+
+  volatile char sink; // Keeps the results alive
+
+  template<typename Read>
+  double ns_per_call(Read read)
+  {
+    const auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < iterations; ++i)
+    {
+      read();
+    }
+
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+  }
+
+  /**
+    * @brief  print_time() as it was: HAL_RTC_GetTime(), HAL_RTC_GetDate()
+    *         and the text made by the format string.
+    */
+  void hal_format(const RTC_TypeDef& rtc, char (&text)[rtc_snapshot::text_size])
+  {
+    rtc_snapshot regs;
+    regs.ssr = rtc.SSR;
+    regs.second_fraction = rtc.PRER & RTC_PRER_PREDIV_S;
+    regs.tr = rtc.TR;
+    const RTC_TimeTypeDef time = hal_get_time(regs);
+    regs.dr = rtc.DR;
+    const RTC_DateTypeDef date = hal_get_date(regs);
+
+    xsprintf(text, "%02u/%02u/%4u %02u:%02u:%02u",
+             date.Date, date.Month, 2000 + date.Year,
+             time.Hours, time.Minutes, time.Seconds);
+  }
+}
+
+int main()
+{
+  RTC_TypeDef rtc = {};
+  rtc.TR = 0x00174000; // 17:40:00
+  rtc.DR = 0x00248509; // Thursday 09/05/24
+  rtc.SSR = 100;
+  rtc.PRER = (127U << 16) | prediv_s;
+
+  char hal_text[rtc_snapshot::text_size];
+  char fast_text[rtc_snapshot::text_size];
+  hal_format(rtc, hal_text);
+  CHECK(std::strcmp(rtc_snapshot::read(&rtc).format(fast_text), hal_text) == 0);
+
+  const double hal_ns = ns_per_call([&]()
+  {
+    char text[rtc_snapshot::text_size];
+    hal_format(rtc, text);
+    sink = text[18];
+  });
+
+  const double fast_ns = ns_per_call([&]()
+  {
+    char text[rtc_snapshot::text_size];
+    sink = rtc_snapshot::read(&rtc).format(text)[18];
+  });
+
+  const double fast_ms_ns = ns_per_call([&]()
+  {
+    char text[rtc_snapshot::text_ms_size];
+    sink = rtc_snapshot::read(&rtc).format_ms(text)[22];
+  });
+
+  std::printf("GET text: HAL + xsprintf %6.1f ns, rtc_snapshot %6.1f ns, rtc_snapshot with ms %6.1f ns\n",
+              hal_ns, fast_ns, fast_ms_ns);
+
+  return host_test::result("rtc_snapshot_bench");
+}
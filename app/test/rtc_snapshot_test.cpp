@@ -0,0 +1,163 @@
+/**
+  ******************************************************************************
+  * @file           : rtc_snapshot_test.cpp
+  * @author         : Rusanov M.N.
+  * @version        : V1.0.0
+  * @date           : 17-Oct-2026
+  * @brief          : Host model test of the direct register reads: the
+  *                   snapshot of every date of the RTC years must decode as
+  *                   HAL_RTC_GetTime()/HAL_RTC_GetDate() do with RTC_FORMAT_BIN
+  *                   and print as the HAL based print_time() did. The
+  *                   milliseconds, the second borrowed after a shift and
+  *                   both shadow register modes of the read are checked too.
+  *
+  ******************************************************************************
+  */
+
+#include <cstdio>
+#include <cstring>
+#include "hal_rtc_model.h"
+#include "host_test.h"
+#include "rtc_calendar.h"
+#include "rtc_snapshot.h"
+
+namespace
+{
+  using namespace hal_rtc_model;
+
+  void test_every_date()
+  {
+    const int32_t first_day = rtc_calendar::days_from_civil(rtc_calendar::rtc_base_year, 1, 1);
+    const int32_t last_day = rtc_calendar::days_from_civil(rtc_calendar::rtc_base_year + 99, 12, 31);
+    bool decoded = true;
+    bool printed = true;
+
+    for (int32_t day = first_day; day <= last_day; ++day)
+    {
+      const rtc_calendar::civil_date civil = rtc_calendar::civil_from_days(day);
+      const auto second = static_cast<uint32_t>(day * 7919) % 86400U; // Spread over the day
+
+      RTC_DateTypeDef date = {};
+      date.Year = static_cast<uint8_t>(civil.year - rtc_calendar::rtc_base_year);
+      date.Month = static_cast<uint8_t>(civil.month);
+      date.Date = static_cast<uint8_t>(civil.day);
+      date.WeekDay = rtc_calendar::weekday_from_days(day);
+
+      RTC_TimeTypeDef time = {};
+      time.Hours = static_cast<uint8_t>(second / 3600);
+      time.Minutes = static_cast<uint8_t>(second / 60 % 60);
+      time.Seconds = static_cast<uint8_t>(second % 60);
+
+      const rtc_snapshot snapshot = make_snapshot(date, time, second % (prediv_s + 1));
+      const RTC_DateTypeDef hal_date = hal_get_date(snapshot);
+      const RTC_TimeTypeDef hal_time = hal_get_time(snapshot);
+      const RTC_DateTypeDef fast_date = snapshot.date();
+      const RTC_TimeTypeDef fast_time = snapshot.time();
+
+      decoded = decoded &&
+        (fast_date.Year == hal_date.Year) && (fast_date.Month == hal_date.Month) &&
+        (fast_date.Date == hal_date.Date) && (fast_date.WeekDay == hal_date.WeekDay) &&
+        (fast_time.Hours == hal_time.Hours) && (fast_time.Minutes == hal_time.Minutes) &&
+        (fast_time.Seconds == hal_time.Seconds) && (fast_time.TimeFormat == hal_time.TimeFormat) &&
+        (fast_time.SubSeconds == hal_time.SubSeconds) && (fast_time.SecondFraction == hal_time.SecondFraction) &&
+        (hal_date.Year == date.Year) && (hal_date.Date == date.Date) && (hal_time.Seconds == time.Seconds);
+
+      // As the HAL based print_time() formatted it
+      char expected[rtc_snapshot::text_size];
+      std::snprintf(expected, sizeof(expected), "%02u/%02u/%4u %02u:%02u:%02u",
+                    hal_date.Date, hal_date.Month, 2000U + hal_date.Year,
+                    hal_time.Hours, hal_time.Minutes, hal_time.Seconds);
+
+      char text[rtc_snapshot::text_size];
+      printed = printed && (std::strcmp(snapshot.format(text), expected) == 0);
+    }
+
+    CHECK(decoded);
+    CHECK(printed);
+  }
+
+  void test_milliseconds()
+  {
+    RTC_DateTypeDef date = { RTC_WEEKDAY_THURSDAY, 5, 9, 24 };
+    RTC_TimeTypeDef time = {};
+    time.Hours = 17;
+    time.Minutes = 40;
+    bool ok = true;
+
+    for (uint32_t ssr = 0; ssr <= prediv_s; ++ssr)
+    {
+      const rtc_snapshot snapshot = make_snapshot(date, time, ssr);
+      const uint32_t ms = (prediv_s - ssr) * 1000 / (prediv_s + 1);
+
+      char expected[rtc_snapshot::text_ms_size];
+      std::snprintf(expected, sizeof(expected), "09/05/2024 17:40:00.%03u", static_cast<unsigned int>(ms));
+
+      char text[rtc_snapshot::text_ms_size];
+      ok = ok && (snapshot.milliseconds() == static_cast<int16_t>(ms)) &&
+           (std::strcmp(snapshot.format_ms(text), expected) == 0);
+    }
+
+    CHECK(ok);
+  }
+
+  void test_after_shift()
+  {
+    // SSR > PREDIV_S right after a shift: the second has not begun yet
+    const RTC_DateTypeDef date = { RTC_WEEKDAY_MONDAY, 1, 1, 1 };
+    const RTC_TimeTypeDef time = {};
+    const rtc_snapshot snapshot = make_snapshot(date, time, prediv_s + 1);
+
+    char text[rtc_snapshot::text_ms_size];
+    CHECK(snapshot.milliseconds() < 0);
+    CHECK(std::strcmp(snapshot.format_ms(text), "31/12/2000 23:59:59.996") == 0);
+
+    const rtc_snapshot normalized = snapshot.normalized();
+    CHECK(normalized.ssr <= prediv_s);
+    CHECK(normalized.date().WeekDay == RTC_WEEKDAY_SUNDAY);
+    CHECK(rtc_calendar::to_epoch_ms(normalized.date(), normalized.time()) ==
+          rtc_calendar::to_epoch_ms(snapshot.date(), snapshot.time()));
+
+    // GET and GET_WD print the normalized snapshot, as GET_MS does
+    char get_text[rtc_snapshot::text_size];
+    CHECK(std::strcmp(normalized.format(get_text), "31/12/2000 23:59:59") == 0);
+    CHECK(std::strcmp(rtc_calendar::weekday_names[normalized.date().WeekDay], "Sun") == 0);
+    CHECK(std::strcmp(snapshot.format(get_text), "01/01/2001 00:00:00") == 0); // The next second
+
+    // Within the second the snapshot stays as it is
+    const rtc_snapshot in_second = make_snapshot(date, time, prediv_s);
+    CHECK(in_second.normalized().tr == in_second.tr);
+    CHECK(in_second.normalized().dr == in_second.dr);
+  }
+
+  void test_read()
+  {
+    RTC_TypeDef rtc = {};
+    rtc.TR = 0x00174000; // 17:40:00
+    rtc.DR = 0x00248509; // Thursday 09/05/24
+    rtc.SSR = 100;
+    rtc.PRER = (127U << 16) | prediv_s;
+
+    const uint32_t shadow_modes[] = { 0U, RTC_CR_BYPSHAD };
+
+    for (const uint32_t cr : shadow_modes)
+    {
+      rtc.CR = cr;
+      const rtc_snapshot snapshot = rtc_snapshot::read(&rtc);
+      char text[rtc_snapshot::text_size];
+
+      CHECK((snapshot.ssr == 100) && (snapshot.second_fraction == prediv_s));
+      CHECK(std::strcmp(snapshot.format(text), "09/05/2024 17:40:00") == 0);
+      CHECK(snapshot.date().WeekDay == RTC_WEEKDAY_THURSDAY);
+    }
+  }
+}
+
+int main()
+{
+  test_every_date();
+  test_milliseconds();
+  test_after_shift();
+  test_read();
+
+  return host_test::result("rtc_snapshot_test");
+}
@@ -0,0 +1,148 @@
+/**
+  ******************************************************************************
+  * @file           : rx_dma_reader_test.cpp
+  * @author         : Rusanov M.N.
+  * @version        : V1.0.0
+  * @date           : 17-Oct-2026
+  * @brief          : Host test of the circular DMA read position used by
+  *                   rtc_internal::process_rx_dma(): frames of every length
+  *                   around the buffer size, the idle line on the wrap,
+  *                   delayed HT/TC interrupts, events without new bytes and
+  *                   the restart of the reception.
+  *
+  ******************************************************************************
+  */
+
+#include "host_test.h"
+#include "rx_dma_reader.h"
+#include "uart_dma_stub.h"
+
+namespace
+{
+  constexpr size_t buf_size = 64; // As rtc_internal::rx_dma_buf_size
+
+  using stub = uart_dma_stub<buf_size>;
+
+  /**
+    * @brief  The reader driven by the stub as by the USART interrupts.
+    */
+  struct receiver
+  {
+    explicit receiver(const size_t latency = 0) : dma(latency)
+    {
+    }
+
+    void receive(const std::vector<uint8_t>& frame)
+    {
+      dma.receive(frame, [this](const stub::event type)
+      {
+        events.push_back(type);
+        reader.read(dma.buf, dma.counter(), [this](const uint8_t c) { received.push_back(c); });
+      });
+    }
+
+    stub dma;
+    rx_dma_reader<buf_size> reader;
+    std::vector<uint8_t> received;
+    std::vector<stub::event> events;
+  };
+
+  std::vector<uint8_t> make_frame(const size_t length, const uint8_t first)
+  {
+    std::vector<uint8_t> result(length);
+    for (size_t i = 0; i < length; ++i)
+    {
+      result[i] = static_cast<uint8_t>(first + i);
+    }
+
+    return result;
+  }
+
+  void test_frame_lengths()
+  {
+    for (size_t latency = 0; latency < buf_size / 2; latency += 7)
+    {
+      bool ok = true;
+
+      for (size_t length = 1; length <= 3 * buf_size + 1; ++length)
+      {
+        receiver rx(latency);
+        std::vector<uint8_t> sent;
+
+        // Several frames, so every start position in the buffer is covered
+        for (size_t frame = 0; frame < 3; ++frame)
+        {
+          const std::vector<uint8_t> bytes = make_frame(length, static_cast<uint8_t>(sent.size()));
+          sent.insert(sent.end(), bytes.begin(), bytes.end());
+          rx.receive(bytes);
+        }
+
+        ok = ok && (rx.received == sent);
+      }
+
+      CHECK(ok);
+    }
+  }
+
+  void test_idle_on_wrap()
+  {
+    receiver rx;
+    rx.receive(make_frame(buf_size, 0));
+
+    CHECK(rx.dma.counter() == buf_size); // NDTR has been reloaded
+    CHECK(rx.reader.position() == 0);
+    CHECK(rx.received.size() == buf_size);
+    CHECK(rx.events.size() == 3); // HT, TC, idle
+
+    if (rx.events.size() == 3)
+    {
+      CHECK(rx.events[0] == stub::event::HALF_TRANSFER);
+      CHECK(rx.events[1] == stub::event::TRANSFER_COMPLETE);
+      CHECK(rx.events[2] == stub::event::IDLE);
+    }
+
+    // The next frame starts at the beginning of the buffer
+    rx.receive({ 'G', 'E', 'T', '\r' });
+    CHECK(rx.received.size() == buf_size + 4);
+    CHECK(rx.received.back() == '\r');
+  }
+
+  void test_events_without_bytes()
+  {
+    receiver rx;
+    rx.receive(make_frame(10, 0));
+
+    // Repeated reads at the same NDTR, e.g. an idle line right after TC
+    for (int i = 0; i < 3; ++i)
+    {
+      rx.reader.read(rx.dma.buf, rx.dma.counter(), [&rx](const uint8_t c) { rx.received.push_back(c); });
+    }
+
+    CHECK(rx.received.size() == 10);
+    CHECK(rx.reader.position() == 10);
+  }
+
+  void test_restart()
+  {
+    receiver rx;
+    rx.receive(make_frame(20, 0));
+
+    // As rtc_internal::uart_error_callback(): the DMA is restarted from scratch
+    rx.dma.restart();
+    rx.reader.reset();
+    rx.received.clear();
+
+    rx.receive(make_frame(5, 100));
+    CHECK(rx.received == make_frame(5, 100));
+  }
+}
+
+int main()
+{
+  test_frame_lengths();
+  test_idle_on_wrap();
+  test_events_without_bytes();
+  test_restart();
+
+  return host_test::result("rx_dma_reader_test");
+}
@@ -0,0 +1,88 @@
+/**
+  ******************************************************************************
+  * @file           : sscanf_bench.cpp
+  * @author         : Rusanov M.N.
+  * @version        : V1.0.0
+  * @date           : 17-Oct-2026
+  * @brief          : Host benchmark of the C library sscanf() on the time/date
+  *                   formats of SET_T and SET_D, as rtc_internal parsed them
+  *                   before, against the streaming parser which has replaced
+  *                   it. The fields of both are checked to match.
+  * @note           : The host times only rank the parsers.
+  *
+  ******************************************************************************
+  */
+
+#include <chrono>
+#include <cstdio>
+#include "host_test.h"
+#include "rtc_cmd_parser.h"
+
+namespace
+{
+  constexpr int iterations = 1000000;
+
+  volatile unsigned int sink; // Keeps the results alive
+
+  template<typename Scan>
+  double ns_per_call(Scan scan)
+  {
+    const auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < iterations; ++i)
+    {
+      scan();
+    }
+
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+  }
+
+  bool parse(const char* cmd, rtc_cmd_parser::cmd_info& info)
+  {
+    rtc_cmd_parser parser;
+
+    for (const char* str = cmd; *str != '\0'; ++str)
+    {
+      if (parser.feed(*str, info))
+      {
+        return info.err == rtc_cmd_parser::cmd_err::OK;
+      }
+    }
+
+    return false;
+  }
+
+  void bench_format(const char* name, const char* input, const char* fmt, const char* cmd)
+  {
+    unsigned int y[3] = {};
+    rtc_cmd_parser::cmd_info info = {};
+    CHECK(std::sscanf(input, fmt, &y[0], &y[1], &y[2]) == 3);
+    CHECK(parse(cmd, info));
+    CHECK((info.args[0] == y[0]) && (info.args[1] == y[1]) && (info.args[2] == y[2]));
+
+    const double y_ns = ns_per_call([&]()
+    {
+      unsigned int a = 0;
+      unsigned int b = 0;
+      unsigned int c = 0;
+      sink = static_cast<unsigned int>(std::sscanf(input, fmt, &a, &b, &c)) + a + b + c;
+    });
+
+    const double p_ns = ns_per_call([&]()
+    {
+      rtc_cmd_parser::cmd_info result = {};
+      sink = parse(cmd, result) + result.args[0] + result.args[1] + result.args[2];
+    });
+
+    std::printf("%-6s sscanf %6.1f ns, rtc_cmd_parser (whole command) %6.1f ns\n", name, y_ns, p_ns);
+  }
+}
+
+int main()
+{
+  bench_format("SET_T", "12:34:56", "%2u:%2u:%2u", "SET_T 12:34:56\r");
+  bench_format("SET_D", "09/05/2024", "%2u/%2u/%4u", "SET_D 09/05/2024\r");
+
+  return host_test::result("sscanf_bench");
+}
@@ -0,0 +1,119 @@
+/**
+  ******************************************************************************
+  * @file           : uart_dma_stub.h
+  * @author         : Rusanov M.N.
+  * @version        : V1.0.0
+  * @date           : 17-Oct-2026
+  * @brief          : Host stub of the USART RX on a circular DMA channel.
+  *                   The received bytes are written to the buffer and NDTR
+  *                   counts down as the hardware does, reloading to Size on
+  *                   the wrap. The half transfer (HT), transfer complete (TC)
+  *                   and idle line events are passed to the handler, which
+  *                   reads NDTR by @ref counter() as the interrupt does.
+  * @note           : The interrupt latency is modelled by delivering HT/TC
+  *                   a number of bytes after they have occurred.
+  *
+  ******************************************************************************
+  */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+template<size_t Size>
+class uart_dma_stub
+{
+public:
+  enum class event
+  {
+    HALF_TRANSFER,
+    TRANSFER_COMPLETE,
+    IDLE
+  };
+
+  volatile uint8_t buf[Size] = {};
+
+  /**
+    * @param  latency : bytes received between HT/TC and its interrupt.
+    */
+  explicit uart_dma_stub(const size_t latency = 0) : f_latency(latency)
+  {
+  }
+
+  /**
+    * @brief  Receives a frame: the bytes, then the idle line.
+    * @param  handler : called with the event, as the interrupt handler.
+    */
+  template<typename Handler>
+  void receive(const std::vector<uint8_t>& frame, Handler handler)
+  {
+    for (const uint8_t c : frame)
+    {
+      buf[Size - f_counter] = c;
+
+      if (--f_counter == Size / 2)
+      {
+        f_pending.push_back({ event::HALF_TRANSFER, f_latency });
+      }
+      else if (f_counter == 0)
+      {
+        f_counter = Size; // Circular mode reloads NDTR
+        f_pending.push_back({ event::TRANSFER_COMPLETE, f_latency });
+      }
+
+      deliver(handler, false);
+    }
+
+    deliver(handler, true);
+    handler(event::IDLE);
+  }
+
+  /**
+    * @retval NDTR: the number of transfers left till the buffer wraps.
+    */
+  [[nodiscard]] size_t counter() const
+  {
+    return f_counter;
+  }
+
+  /**
+    * @brief  Restarts the DMA at the beginning of the buffer.
+    */
+  void restart()
+  {
+    f_counter = Size;
+    f_pending.clear();
+  }
+
+private:
+  struct pending_event
+  {
+    event type;
+    size_t delay; // Bytes till the interrupt
+  };
+
+  template<typename Handler>
+  void deliver(Handler& handler, const bool all)
+  {
+    for (size_t i = 0; i < f_pending.size();)
+    {
+      if (all || (f_pending[i].delay == 0))
+      {
+        const event type = f_pending[i].type;
+        f_pending.erase(f_pending.begin() + static_cast<std::ptrdiff_t>(i));
+        handler(type);
+      }
+      else
+      {
+        --f_pending[i].delay;
+        ++i;
+      }
+    }
+  }
+
+  const size_t f_latency;
+  size_t f_counter = Size;
+  std::vector<pending_event> f_pending;
+};
@@ -6,10 +6,17 @@
   */
 
 #include "xuart_stream.h"
+#include <algorithm>
+#include "irq_lock.h"
+#include "tcm.h"
 
 void std_out(int c);
 int std_in();
 
+#if XF_USE_OUTPUT
+DTCM_BSS uint8_t xuart_stream::f_tx_ring[xuart_stream::tx_ring_size];
+#endif
+
 xuart_stream::xuart_stream()
 {
 #if XF_USE_OUTPUT
@@ -32,80 +39,315 @@ void xuart_stream::init(UART_HandleTypeDef& huart)
   f_huart = &huart;
 
 #if XF_USE_OUTPUT
-  f_max_transmission_time_ms = (tx_buf_size * (1 + 8 + 2) * 1000 / huart.Init.BaudRate + 2) * 3;
-  f_tx_buf[0] = 0;
-  f_tx_buf_idx = 0;
+  f_max_transmission_time_ms = (tx_dma_max_size * (1 + 8 + 2) * 1000 / huart.Init.BaudRate + 2) * 3;
+  f_tx_tail = 0;
+  f_tx_pend = 0;
+  f_tx_head = 0;
+  f_tx_fill = 0;
+  f_tx_line = 0;
+  f_tx_line_dropped = false;
+  f_tx_line_cut = false;
+  f_tx_batch = false;
+  f_tx_busy = false;
 #endif
 }
 
 #if XF_USE_OUTPUT
-void std_out(const int c)
+ITCM_CODE void std_out(const int c)
 {
   xuart_stream::get_instance().output_stream(static_cast<char>(c));
 }
 
-void xuart_stream::output_stream(const char c)
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart)
+{
+  xuart_stream::get_instance().uart_tx_cplt_callback(huart);
+}
+
+ITCM_CODE void xuart_stream::output_stream(const char c)
+{
+  // The lost output is counted by dropped_bytes(): it must never stop the board.
+  static_cast<void>((c != str_terminate_char) ? add_char(c) : add_endl());
+}
+
+void xuart_stream::set_tx_policy(const tx_policy policy)
+{
+  f_tx_policy = policy;
+}
+
+uint32_t xuart_stream::dropped_bytes() const
 {
-  if (c != str_terminate_char)
+  return f_tx_dropped;
+}
+
+/**
+  * @retval Number of bytes that can be printed without waiting for DMA.
+  */
+uint32_t xuart_stream::free_space() const
+{
+  return tx_ring_size - (f_tx_fill - f_tx_tail);
+}
+
+/**
+  * @brief  Waits until all queued data has been transmitted.
+  */
+void xuart_stream::flush()
+{
+  commit();
+
+  uint32_t tail = f_tx_tail;
+  uint32_t start_tick = HAL_GetTick();
+
+  while (f_tx_busy || (f_tx_tail != f_tx_head))
   {
-    if (add_char(c) != status::OK)
+    if (tail != f_tx_tail)
     {
-      Error_Handler();
+      tail = f_tx_tail;
+      start_tick = HAL_GetTick();
     }
-  }
-  else
-  {
-    if (add_endl() != status::OK)
+    else if (HAL_GetTick() - start_tick > f_max_transmission_time_ms)
     {
-      Error_Handler();
+      return;
     }
   }
 }
 
-xuart_stream::status xuart_stream::transmit_data(const uint8_t& data, const uint16_t size) const
+/**
+  * @brief  Holds the completed lines in the ring until @ref end_batch(),
+  *         so the replies to several commands go out in one transmission.
+  * @note   Lines longer than one DMA transfer and a full ring are still
+  *         committed without waiting for the end of the batch.
+  */
+void xuart_stream::begin_batch()
+{
+  f_tx_batch = true;
+}
+
+void xuart_stream::end_batch()
 {
-  if (HAL_UART_Transmit(f_huart, &data, size, f_max_transmission_time_ms) != HAL_OK)
+  f_tx_batch = false;
+  commit();
+}
+
+/**
+  * @brief  Must be called in the HAL_UART_TxCpltCallback(): chains the next
+  *         DMA transfer of the data queued meanwhile.
+  */
+void xuart_stream::uart_tx_cplt_callback(const UART_HandleTypeDef* huart)
+{
+  if (huart == f_huart)
   {
-    return status::ERROR;
+    f_tx_tail = f_tx_pend;
+    f_tx_busy = false;
+    start_transmission();
   }
+}
 
-  return status::OK;
+/**
+  * @brief  Must be called in the HAL_UART_ErrorCallback(). If the HAL has
+  *         aborted the transmission, the data of the aborted transfer is lost.
+  */
+void xuart_stream::uart_error_callback(const UART_HandleTypeDef* huart)
+{
+  if ((huart == f_huart) && f_tx_busy && (f_huart->gState == HAL_UART_STATE_READY))
+  {
+    f_tx_dropped = f_tx_dropped + (f_tx_pend - f_tx_tail);
+    uart_tx_cplt_callback(huart);
+  }
+}
+
+/**
+  * @brief  Starts DMA transfer of the queued data if the UART is idle.
+  * @note   Can be called from both the main loop and the interrupt.
+  */
+void xuart_stream::start_transmission()
+{
+  const irq_lock lock;
+
+  if (f_tx_busy || (f_tx_pend == f_tx_head))
+  {
+    return;
+  }
+
+  const uint32_t offset = f_tx_pend & (tx_ring_size - 1);
+  const uint32_t size = std::min({ f_tx_head - f_tx_pend,
+                                   tx_ring_size - offset,
+                                   static_cast<uint32_t>(tx_dma_max_size) });
+  f_tx_tail = f_tx_pend;
+
+  if (HAL_UART_Transmit_DMA(f_huart, &f_tx_ring[offset], static_cast<uint16_t>(size)) != HAL_OK)
+  {
+    f_tx_dropped = f_tx_dropped + (f_tx_head - f_tx_pend);
+    f_tx_pend = f_tx_head;
+    f_tx_tail = f_tx_head;
+    return;
+  }
+
+  f_tx_busy = true;
+  f_tx_pend = f_tx_pend + size;
 }
 
-xuart_stream::status xuart_stream::add_char(const char c)
+/**
+  * @brief  Frees at least size bytes in the ring according to @ref f_tx_policy.
+  * @retval false if the data must be dropped.
+  */
+bool xuart_stream::make_room(const uint16_t size)
 {
-  f_tx_buf[f_tx_buf_idx++] = c;
+  uint32_t tail = f_tx_tail;
+  uint32_t start_tick = HAL_GetTick();
 
-  if (f_tx_buf_idx >= tx_buf_size)
+  while (tx_ring_size - (f_tx_fill - f_tx_tail) < size)
   {
-    if (transmit_data(f_tx_buf[0], f_tx_buf_idx) != status::OK)
+    if (f_tx_policy == tx_policy::DROP_NEWEST)
     {
-      return status::ERROR;
+      return false;
     }
 
-    f_tx_buf_idx = 0;
+    if ((f_tx_policy == tx_policy::DROP_OLDEST) && (f_tx_pend != f_tx_head))
+    {
+      drop_oldest_line();
+      continue;
+    }
+
+    if (f_tx_pend == f_tx_head)
+    {
+      commit(); // The ring is full of the line being formatted
+    }
+
+    start_transmission();
+
+    if (tail != f_tx_tail)
+    {
+      tail = f_tx_tail;
+      start_tick = HAL_GetTick();
+    }
+    else if (HAL_GetTick() - start_tick > f_max_transmission_time_ms)
+    {
+      return false; // The UART is stuck
+    }
   }
 
-  return status::OK;
+  return true;
+}
+
+/**
+  * @brief  Discards the oldest line not yet passed to DMA. Its space is reused
+  *         as soon as the current DMA transfer completes.
+  */
+void xuart_stream::drop_oldest_line()
+{
+  const irq_lock lock;
+
+  uint32_t pend = f_tx_pend;
+  while (pend != f_tx_head)
+  {
+    if (f_tx_ring[pend++ & (tx_ring_size - 1)] == str_terminate_char)
+    {
+      break;
+    }
+  }
+
+  f_tx_dropped = f_tx_dropped + (pend - f_tx_pend);
+  f_tx_pend = pend;
+
+  if (!f_tx_busy)
+  {
+    f_tx_tail = pend;
+  }
+}
+
+/**
+  * @brief  Hands the formatted data over to DMA.
+  */
+void xuart_stream::commit()
+{
+  f_tx_head = f_tx_fill;
+  start_transmission();
+}
+
+/**
+  * @brief  Discards the uncommitted part of the current line and the rest
+  *         of it up to the end of line. If the start of a long line has
+  *         already been committed, the line is ended by @ref close_cut_line().
+  */
+void xuart_stream::drop_line()
+{
+  // The line may start before the committed chunk of a long line
+  const uint32_t line = ((f_tx_fill - f_tx_line) < (f_tx_fill - f_tx_head)) ? f_tx_line : f_tx_head;
+
+  f_tx_dropped = f_tx_dropped + (f_tx_fill - line);
+  f_tx_fill = line;
+  f_tx_line_dropped = true;
+  f_tx_line_cut = f_tx_line_cut || (line != f_tx_line);
 }
 
-xuart_stream::status xuart_stream::add_endl()
+/**
+  * @brief  Ends the committed start of a line cut by @ref drop_line(), so
+  *         the terminal does not merge it with the next line. Retried by
+  *         the next output while the ring has no room.
+  */
+void xuart_stream::close_cut_line()
 {
-  if (add_char(str_terminate_char) != status::OK)
+  if (f_tx_line_cut && make_room(1))
   {
+    f_tx_ring[f_tx_fill++ & (tx_ring_size - 1)] = static_cast<uint8_t>(str_terminate_char);
+    f_tx_line = f_tx_fill;
+    f_tx_line_cut = false;
+  }
+}
+
+ITCM_CODE xuart_stream::status xuart_stream::add_char(const char c)
+{
+  if (f_tx_line_dropped)
+  {
+    f_tx_dropped = f_tx_dropped + 1;
     return status::ERROR;
   }
 
-  const uint16_t len = f_tx_buf_idx;
-  f_tx_buf_idx = 0;
+  close_cut_line();
 
-  if (transmit_data(f_tx_buf[0], len) != status::OK)
+  if (!make_room(1))
   {
+    drop_line();
+
+    // The end of a cut line is not lost: close_cut_line() sends it
+    f_tx_dropped = f_tx_dropped + (((c == str_terminate_char) && f_tx_line_cut) ? 0 : 1);
     return status::ERROR;
   }
 
+  f_tx_ring[f_tx_fill++ & (tx_ring_size - 1)] = static_cast<uint8_t>(c);
+
+  if (f_tx_fill - f_tx_head >= tx_dma_max_size)
+  {
+    commit(); // Long lines are transmitted in chunks
+  }
+
   return status::OK;
 }
+
+ITCM_CODE xuart_stream::status xuart_stream::add_endl()
+{
+  status result = status::ERROR;
+
+  if (!f_tx_line_dropped)
+  {
+    result = add_char(str_terminate_char);
+  }
+  else if (!f_tx_line_cut)
+  {
+    f_tx_dropped = f_tx_dropped + 1; // The whole line is dropped with its end
+  }
+
+  f_tx_line_dropped = false;
+  f_tx_line = f_tx_fill;
+  close_cut_line();
+
+  if (!f_tx_batch)
+  {
+    commit();
+  }
+
+  return result;
+}
 #endif
 
 #if XF_USE_INPUT
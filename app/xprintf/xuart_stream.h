@@ -9,6 +9,11 @@
   *                   library stream.
   * @note           : The library has not worked out thread-safety.
   *                   It is safe to call 'xprintf' only from one thread.
+  *                   'xprintf' formats the output straight into a ring
+  *                   buffer. Each completed line is committed to DMA
+  *                   without copying, so 'xprintf' does not wait for the UART.
+  *                   The lines printed between begin_batch() and end_batch()
+  *                   are committed together as one transmission.
   *
   ******************************************************************************
   */
@@ -27,11 +32,27 @@ public:
     ERROR
   };
 
+  // What to do with the output when the TX ring buffer is full
+  enum class tx_policy
+  {
+    BLOCK,       // Wait until DMA frees the space (never use from interrupts)
+    DROP_NEWEST, // Discard the data being written
+    DROP_OLDEST  // Discard the oldest lines not yet passed to DMA
+  };
+
   [[nodiscard]] static xuart_stream& get_instance();
   void init(UART_HandleTypeDef& huart);
 
 #if XF_USE_OUTPUT
   void output_stream(char c);
+  void set_tx_policy(tx_policy policy);
+  void flush();
+  void begin_batch();
+  void end_batch();
+  void uart_tx_cplt_callback(const UART_HandleTypeDef* huart);
+  void uart_error_callback(const UART_HandleTypeDef* huart);
+  [[nodiscard]] uint32_t dropped_bytes() const;
+  [[nodiscard]] uint32_t free_space() const;
 #endif
 
 #if XF_USE_INPUT
@@ -42,19 +63,40 @@ private:
   explicit xuart_stream();
 
 #if XF_USE_OUTPUT
-  [[nodiscard]] status transmit_data(const uint8_t &data, uint16_t size) const;
   [[nodiscard]] status add_char(char c);
   [[nodiscard]] status add_endl();
+  [[nodiscard]] bool make_room(uint16_t size);
+  void commit();
+  void drop_line();
+  void close_cut_line();
+  void drop_oldest_line();
+  void start_transmission();
 #endif
 
 private:
-  static constexpr uint16_t tx_buf_size = 32;
+  static constexpr uint32_t tx_ring_size = 2048;  // Must be a power of 2
+  static constexpr uint16_t tx_dma_max_size = 256; // Max size of one DMA transfer
   static constexpr char str_terminate_char = '\r'; // '\r' or '\n'
+  static_assert((tx_ring_size & (tx_ring_size - 1)) == 0, "tx_ring_size must be a power of 2");
   UART_HandleTypeDef* f_huart = nullptr;
 
 #if XF_USE_OUTPUT
   uint32_t f_max_transmission_time_ms = 0;
-  uint8_t f_tx_buf[tx_buf_size] = { 0 };
-  uint16_t f_tx_buf_idx = 0;
+  tx_policy f_tx_policy = tx_policy::BLOCK;
+
+  // Ring indexes are free-running: [tail, pend) is transmitted by DMA,
+  // [pend, head) is committed and waits for the next DMA transfer,
+  // [head, fill) is being formatted by 'xprintf' (several lines in a batch).
+  static uint8_t f_tx_ring[tx_ring_size]; // In DTCM: uncached, DMA reads what the CPU has written
+  volatile uint32_t f_tx_tail = 0;
+  volatile uint32_t f_tx_pend = 0;
+  volatile uint32_t f_tx_head = 0;
+  uint32_t f_tx_fill = 0;
+  uint32_t f_tx_line = 0; // Start of the line being formatted
+  bool f_tx_line_dropped = false;
+  bool f_tx_line_cut = false; // The committed start of a dropped line waits for its end
+  bool f_tx_batch = false;
+  volatile bool f_tx_busy = false;
+  volatile uint32_t f_tx_dropped = 0;
 #endif
 };
\ No newline at end of file
@@ -0,0 +1,149 @@
+"""
+@file    : map_file.py
+@author  : Rusanov M.N.
+@brief   : Parser of the GNU ld map file for the reports in this directory.
+"""
+
+import re
+from dataclasses import dataclass, field
+
+HEX = r"0x[0-9a-fA-F]+"
+OUTPUT_SECTION = re.compile(rf"^(\.\S+)(?:\s+({HEX})\s+({HEX})(?:\s+load address\s+({HEX}))?)?\s*$")
+ADDRESS_SIZE = re.compile(rf"^\s+({HEX})\s+({HEX})(?:\s+load address\s+({HEX}))?\s*$")
+INPUT_SECTION = re.compile(rf"^ ([^\s*]\S*)(?:\s+({HEX})\s+({HEX})\s+(\S.*))?$")
+ADDRESS_SIZE_FILE = re.compile(rf"^\s+({HEX})\s+({HEX})\s+(\S.*)$")
+SYMBOL = re.compile(rf"^\s+({HEX})\s{{2,}}(\S.*)$")
+REGION = re.compile(rf"^(\S+)\s+({HEX})\s+({HEX})")
+
+
+@dataclass
+class InputSection:
+    name: str
+    address: int
+    size: int
+    file: str
+
+
+@dataclass
+class OutputSection:
+    name: str
+    address: int = 0
+    size: int = 0
+    load_address: int = 0
+    inputs: list = field(default_factory=list)
+    symbols: list = field(default_factory=list)  # (address, name)
+
+
+@dataclass(frozen=True)
+class Region:
+    name: str
+    origin: int
+    length: int
+
+    def contains(self, address):
+        return self.origin <= address < self.origin + self.length
+
+
+@dataclass
+class MapFile:
+    regions: list = field(default_factory=list)
+    sections: list = field(default_factory=list)
+    archive_members: list = field(default_factory=list)  # (member, referencing file, symbol)
+
+    def region_of(self, address):
+        return next((region for region in self.regions if region.contains(address)), None)
+
+
+def parse(path):
+    with open(path, encoding="utf-8", errors="replace") as lines:
+        return parse_lines(line.rstrip("\n") for line in lines)
+
+
+def parse_lines(lines):
+    result = MapFile()
+    part = None
+    member = None
+    current = None
+    pending = None  # Name of the section whose address and size are on the next line
+
+    for line in lines:
+        if line.startswith("Archive member included"):
+            part = "archive"
+            continue
+        if line.startswith("Memory Configuration"):
+            part = "memory"
+            continue
+        if line.startswith("Linker script and memory map"):
+            part = "map"
+            continue
+        if line.startswith(("Discarded input sections", "Allocating common symbols", "Cross Reference Table")):
+            part = None
+            continue
+        if not line.strip():
+            continue
+
+        if part == "archive":
+            if not line.startswith(" "):
+                member, _, line = line.partition(" ")  # A short member name is followed by the reference
+            if line.strip() and member is not None:
+                referrer, _, symbol = line.strip().partition(" (")
+                result.archive_members.append((member, referrer, symbol.rstrip(")")))
+            continue
+
+        if part == "memory":
+            match = REGION.match(line)
+            if match and match.group(1) not in ("Name", "*default*"):
+                result.regions.append(Region(match.group(1), int(match.group(2), 16), int(match.group(3), 16)))
+            continue
+
+        if part != "map":
+            continue
+
+        if not line.startswith(" "):
+            match = OUTPUT_SECTION.match(line)
+            current = OutputSection(match.group(1)) if match else None
+            pending = None
+            if current is not None:
+                result.sections.append(current)
+                if match.group(2) is None:
+                    pending = current
+                else:
+                    _set_output(current, match.group(2), match.group(3), match.group(4))
+            continue
+
+        if current is None:
+            continue
+
+        if isinstance(pending, OutputSection):
+            match = ADDRESS_SIZE.match(line)
+            if match:
+                _set_output(current, *match.groups())
+            pending = None
+            continue
+
+        if isinstance(pending, str):
+            name, pending = pending, None
+            match = ADDRESS_SIZE_FILE.match(line)
+            if match:
+                current.inputs.append(InputSection(name, int(match.group(1), 16), int(match.group(2), 16), match.group(3)))
+                continue
+
+        match = INPUT_SECTION.match(line)
+        if match:
+            if match.group(2) is None:
+                pending = match.group(1)
+            else:
+                current.inputs.append(InputSection(match.group(1), int(match.group(2), 16), int(match.group(3), 16), match.group(4)))
+            continue
+
+        match = SYMBOL.match(line)
+        if match and not match.group(2).startswith(("0x", ".", "*", "PROVIDE", "ASSERT")) and "=" not in match.group(2):
+            current.symbols.append((int(match.group(1), 16), match.group(2).strip()))
+
+    return result
+
+
+def _set_output(section, address, size, load_address):
+    section.address = int(address, 16)
+    section.size = int(size, 16)
+    section.load_address = int(load_address, 16) if load_address else section.address
@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+"""
+@file    : mem_budget.py
+@author  : Rusanov M.N.
+@brief   : Static memory budget of the firmware from the GNU ld map file:
+           the use of each memory region, the bytes of each module (object
+           file or library) in each region and the library members linked in
+           for the dynamic allocation.
+           Usage: mem_budget.py <firmware.map> [REGION=percent ...]
+           The exit code is 1 if a region is used above its limit, e.g.
+           mem_budget.py Release/EmbeddedProject1.map FLASH=50 RAM=80
+           The initialized data and the ITCM code are counted both in
+           the region they run from and in the region they are loaded from.
+"""
+
+import os
+import re
+import sys
+import map_file
+
+NOT_ALLOCATED = (".debug", ".comment", ".ARM.attributes", ".stab", ".gnu.attributes")
+RESERVATIONS = {"._user_heap_stack": "[heap + stack reservation]"}
+HEAP_SYMBOLS = ("malloc", "_malloc_r", "calloc", "_calloc_r", "realloc", "_realloc_r", "_sbrk", "_sbrk_r", "operator new")
+ARCHIVE = re.compile(r"^(.*?\.a)\(.*\)$")
+
+
+def module_of(path):
+    match = ARCHIVE.match(path)
+    return os.path.basename(match.group(1) if match else path)
+
+
+def main(argv):
+    if len(argv) < 2:
+        print(__doc__.strip())
+        return 2
+
+    memory = map_file.parse(argv[1])
+    limits = {name: float(percent) for name, _, percent in (arg.partition("=") for arg in argv[2:])}
+    regions = [region.name for region in memory.regions]
+    used = dict.fromkeys(regions, 0)
+    modules = {}
+
+    for section in memory.sections:
+        if section.name.startswith(NOT_ALLOCATED) or section.size == 0:
+            continue
+
+        for region in {memory.region_of(section.address), memory.region_of(section.load_address)} - {None}:
+            used[region.name] += section.size
+
+        offset = section.load_address - section.address
+
+        if section.name in RESERVATIONS:
+            region = memory.region_of(section.address)
+            modules[RESERVATIONS[section.name]] = dict.fromkeys(regions, 0)
+            if region is not None:
+                modules[RESERVATIONS[section.name]][region.name] = section.size
+            continue
+
+        for input_section in section.inputs:
+            if input_section.size:
+                module = module_of(input_section.file)
+                places = {memory.region_of(input_section.address), memory.region_of(input_section.address + offset)}
+                for region in places - {None}:
+                    modules.setdefault(module, dict.fromkeys(regions, 0))[region.name] += input_section.size
+
+    result = 0
+    print(f"{'Region':<12}{'Used':>10}{'Length':>10}{'%':>8}")
+    for region in memory.regions:
+        percent = 100.0 * used[region.name] / region.length
+        print(f"{region.name:<12}{used[region.name]:>10}{region.length:>10}{percent:>8.1f}")
+        if percent > limits.get(region.name, 100.0):
+            print(f"Error: {region.name} is used above {limits[region.name]}%")
+            result = 1
+
+    print()
+    print(f"{'Module':<32}" + "".join(f"{name:>10}" for name in regions))
+    for module, sizes in sorted(modules.items(), key=lambda item: -sum(item[1].values())):
+        print(f"{module:<32}" + "".join(f"{sizes[name]:>10}" for name in regions))
+
+    heap_users = [(member, referrer, symbol) for member, referrer, symbol in memory.archive_members
+                  if symbol.startswith(HEAP_SYMBOLS)]
+    print()
+    print(f"Heap users: {len(heap_users)}")
+    for member, referrer, symbol in heap_users:
+        print(f"  {os.path.basename(referrer)} -> {symbol} from {os.path.basename(member)}")
+
+    return result
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,174 @@
+#!/usr/bin/env python3
+"""
+@file    : stack_usage.py
+@author  : Rusanov M.N.
+@brief   : Worst-case static stack analysis of the firmware from the call
+           graphs made by GCC with -fcallgraph-info=su (the .ci files next
+           to the object files).
+           Usage: stack_usage.py <object dir> [source dir ...]
+           The deepest call path is found from main() and from each
+           exception handler. The preemption priorities of the handlers are
+           read from the HAL_NVIC_SetPriority() calls in the sources
+           (Core/Src by default): the handlers of the same priority don't
+           nest, so the worst case is main() plus the deepest handler of
+           each priority with its exception frame.
+           The exit code is 1 if the worst case exceeds _Min_Stack_Size.
+"""
+
+import os
+import re
+import sys
+
+REPO = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+LINKER_SCRIPT = os.path.join(REPO, "STM32F746NGHX_FLASH.ld")
+HAL_CONF = os.path.join(REPO, "Core", "Inc", "stm32f7xx_hal_conf.h")
+
+# Exception frame with the FPU context (lazy stacking reserves it) and the alignment word
+EXCEPTION_FRAME = 26 * 4 + 4
+
+# Fixed and reset priorities of the system handlers, SysTick is set by HAL_InitTick()
+SYSTEM_PRIORITIES = {
+    "NMI_Handler": -2,
+    "HardFault_Handler": -1,
+    "MemManage_Handler": 0,
+    "BusFault_Handler": 0,
+    "UsageFault_Handler": 0,
+    "SVC_Handler": 0,
+    "DebugMon_Handler": 0,
+    "PendSV_Handler": 0,
+}
+
+NODE = re.compile(r'^node: \{ title: "([^"]+)" label: "([^"]*)"')
+EDGE = re.compile(r'^edge: \{ sourcename: "([^"]+)" targetname: "([^"]+)"')
+FRAME = re.compile(r"(\d+) bytes \((\w+(?:,\w+)*)\)")
+SET_PRIORITY = re.compile(r"HAL_NVIC_SetPriority\(\s*(\w+)_IRQn\s*,\s*(\w+)")
+TICK_PRIORITY = re.compile(r"#define\s+TICK_INT_PRIORITY\s+\(\(uint32_t\)(\d+)U\)")
+MIN_STACK_SIZE = re.compile(r"_Min_Stack_Size\s*=\s*(0x[0-9a-fA-F]+|\d+)")
+
+
+class CallGraph:
+    def __init__(self):
+        self.names = {}   # Title -> readable name
+        self.frames = {}  # Title -> (bytes, qualifier) of the defined functions
+        self.calls = {}   # Title -> set of titles
+        self.depths = {}  # Title -> (bytes, path, warnings)
+
+    def load(self, path):
+        with open(path, encoding="utf-8", errors="replace") as lines:
+            for line in lines:
+                match = NODE.match(line)
+                if match:
+                    title, label = match.groups()
+                    self.names.setdefault(title, label.split("\\n")[0])
+                    frame = FRAME.search(label)
+                    if frame:
+                        self.frames[title] = (int(frame.group(1)), frame.group(2))
+                    continue
+
+                match = EDGE.match(line)
+                if match:
+                    self.calls.setdefault(match.group(1), set()).add(match.group(2))
+
+    def depth(self, title, active=()):
+        """Returns (bytes, path, warnings) of the deepest call path from the function."""
+        if title in self.depths:
+            return self.depths[title]
+
+        if title in active:
+            return 0, [], {f"recursion in {self.names.get(title, title)}"}
+
+        warnings = set()
+        if title == "__indirect_call":
+            return 0, [], {"indirect call"}
+        if title not in self.frames:
+            return 0, [title], {f"no stack info for {self.names.get(title, title)}"}
+
+        size, qualifier = self.frames[title]
+        if qualifier != "static":
+            warnings.add(f"{qualifier} frame in {self.names.get(title, title)}")
+
+        deepest = (0, [], set())
+        for callee in sorted(self.calls.get(title, ())):
+            callee_depth = self.depth(callee, active + (title,))
+            warnings |= callee_depth[2]
+            if callee_depth[0] > deepest[0] or not deepest[1]:
+                deepest = callee_depth
+
+        result = (size + deepest[0], [title] + deepest[1], warnings)
+        if not any(warning.startswith("recursion") for warning in warnings):
+            self.depths[title] = result  # The depth under a recursion depends on the caller
+        return result
+
+
+def read_priorities(source_dirs):
+    priorities = dict(SYSTEM_PRIORITIES)
+
+    with open(HAL_CONF, encoding="utf-8", errors="replace") as conf:
+        match = TICK_PRIORITY.search(conf.read())
+        priorities["SysTick_Handler"] = int(match.group(1)) if match else 0
+
+    for source_dir in source_dirs:
+        for name in sorted(os.listdir(source_dir)):
+            if name.endswith((".c", ".cpp")):
+                with open(os.path.join(source_dir, name), encoding="utf-8", errors="replace") as source:
+                    for irq, priority in SET_PRIORITY.findall(source.read()):
+                        priorities[irq + "_IRQHandler"] = int(priority) if priority.isdigit() else 0
+
+    return priorities
+
+
+def main(argv):
+    if len(argv) < 2:
+        print(__doc__.strip())
+        return 2
+
+    graph = CallGraph()
+    for root, _, files in os.walk(argv[1]):
+        for name in files:
+            if name.endswith(".ci"):
+                graph.load(os.path.join(root, name))
+
+    if "main" not in graph.frames:
+        print("Error: no call graph of main(), build with -fcallgraph-info=su")
+        return 2
+
+    priorities = read_priorities(argv[2:] or [os.path.join(REPO, "Core", "Src")])
+
+    with open(LINKER_SCRIPT, encoding="utf-8", errors="replace") as script:
+        match = MIN_STACK_SIZE.search(script.read())
+        reserved = int(match.group(1), 0) if match else 0
+
+    def show(entry, label):
+        size, path, warnings = graph.depth(entry)
+        print(f"{label:<28}{size:>6} bytes: " + " -> ".join(graph.names.get(title, title) for title in path))
+        for warning in sorted(warnings):
+            print(f"{'':<28}warning: {warning}")
+        return size
+
+    total = show("main", "main")
+
+    # The deepest handler of each preemption priority, the handlers without a priority
+    # are assumed to be able to preempt everything
+    levels = {}
+    for title in sorted(graph.frames):
+        if title.endswith(("_IRQHandler", "_Handler")):
+            priority = priorities.get(title, 0)
+            size = show(title, f"{title} ({priority})")
+            if size >= levels.get(priority, (-1, ""))[0]:
+                levels[priority] = (size, title)
+
+    for priority in sorted(levels, reverse=True):
+        size, title = levels[priority]
+        total += size + EXCEPTION_FRAME
+        print(f"Priority {priority}: {title} {size} + {EXCEPTION_FRAME} bytes of the exception frame")
+
+    print(f"Worst case: {total} bytes, reserved {reserved} bytes (_Min_Stack_Size)")
+    if total > reserved:
+        print("Error: the worst case exceeds the reservation")
+        return 1
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+"""
+@file    : tcm_report.py
+@author  : Rusanov M.N.
+@brief   : Reports what the linker has placed into ITCM and DTCM and checks
+           that the hot paths are there.
+           Usage: tcm_report.py <firmware.map> [name ...]
+           The names default to the hot paths of the firmware. The exit code
+           is 1 if any of them is not found in the TCM sections.
+"""
+
+import sys
+import map_file
+
+TCM_SECTIONS = {
+    ".itcm_text": ("ITCM", 16 * 1024),
+    ".dtcm_data": ("DTCM", 64 * 1024),
+    ".dtcm_bss": ("DTCM", 64 * 1024),
+}
+
+HOT_PATHS = [
+    "USART1_IRQHandler",
+    "HAL_UART_IRQHandler",
+    "rtc_internal::forming_rx_msg",
+    "rtc_internal::process_rx_dma",
+    "rtc_cmd_parser::feed",
+    "xvfprintf",
+    "xuart_stream::output_stream",
+    "rtc_internal::f_rx_dma_buf",
+    "xuart_stream::f_tx_ring",
+]
+
+
+def main(argv):
+    if len(argv) < 2:
+        print(__doc__.strip())
+        return 2
+
+    sections = [section for section in map_file.parse(argv[1]).sections if section.name in TCM_SECTIONS]
+    names = argv[2:] or HOT_PATHS
+    found = set()
+    used = {}
+
+    for section in sections:
+        region, length = TCM_SECTIONS[section.name]
+        used[region] = (used.get(region, (0, length))[0] + section.size, length)
+        print(f"{section.name} ({region}): {section.size} bytes")
+
+        for input_section in section.inputs:
+            if input_section.size:
+                print(f"  0x{input_section.address:08X} {input_section.size:6} {input_section.name} {input_section.file}")
+            for wanted in names:
+                if input_section.name.endswith("." + wanted):
+                    found.add(wanted)
+
+        for address, symbol in section.symbols:
+            print(f"    0x{address:08X} {symbol}")
+            for wanted in names:
+                if symbol == wanted or symbol.startswith(wanted + "("):
+                    found.add(wanted)
+
+    for region, (size, length) in used.items():
+        print(f"{region}: {size} of {length} bytes used")
+
+    missing = [name for name in names if name not in found]
+    for name in missing:
+        print(f"Error: {name} is not in TCM")
+
+    return 1 if missing else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))